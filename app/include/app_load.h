@@ -0,0 +1,21 @@
+#ifndef MSREAL_VGA_DRIVER_APP_INCLUDE_APP_LOAD_H_
+#define MSREAL_VGA_DRIVER_APP_INCLUDE_APP_LOAD_H_
+
+#include <stdbool.h>
+
+struct load_config
+{
+    const char* device;
+    const char* file;       // command file, "-" for stdin, NULL for synthetic commands
+    double rate;            // target commands per second, 0 - as fast as possible
+    unsigned long count;    // synthetic commands to send, 0 - until duration runs out
+    double duration;        // seconds, 0 - until count is reached / end of file
+    unsigned int batch;     // commands per write
+    unsigned int seed;
+    bool use_mmap;
+};
+
+int load_parse_args(int , char** , struct load_config* );
+int load_run(const struct load_config* );
+
+#endif //MSREAL_VGA_DRIVER_APP_INCLUDE_APP_LOAD_H_
@@ -1,6 +1,8 @@
 #include <stdbool.h>
 
+struct vga;
+
 #define BUFF_SIZE 50
 
-void cases(const unsigned int , bool* );
+void cases(struct vga* , const unsigned int , bool* );
 void menu(unsigned int* );
\ No newline at end of file
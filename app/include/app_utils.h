@@ -1,3 +1,5 @@
+struct vga;
+
 void KeyboardInit(void);
 void reset_string(char* );
-void sendToDriver(const char* );
+void flushToDriver(struct vga* );
@@ -0,0 +1,100 @@
+#ifndef MSREAL_VGA_DRIVER_APP_INCLUDE_LIBVGA_H_
+#define MSREAL_VGA_DRIVER_APP_INCLUDE_LIBVGA_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "Point.h"
+
+#define VGA_DEVICE "/dev/vga_dma"
+#define VGA_WIDTH 640
+#define VGA_HEIGHT 480
+#define VGA_SUBMIT_SIZE 4096 // same as the chunk size the driver parses per write
+
+// vga_open flags
+#define VGA_NO_MMAP 0x1
+#define VGA_SHADOW 0x2  // map the driver's shadow frame, only the rows written to are copied to the screen
+#define VGA_NO_AUTOFLUSH 0x4    // only vga_flush writes: a command that doesn't fit fails with ENOBUFS
+#define VGA_DIRECT_FLUSH 0x8    // pixels and filled rects flush the queued commands and go through the mapping,
+                                // without it they're queued as commands while the submission buffer isn't empty
+
+#define VGA_SHADOW_OFFSET 0x40000000 // same as DEFIO_MMAP_OFFSET in the driver
+
+// vga_blank levels, same as VGA_BLANK_* in the driver's VgaIoctl.h
+#define VGA_BLANK_OFF 0     // the frame is shown
+#define VGA_BLANK_ON 1      // scanout stopped, drawing goes on
+#define VGA_BLANK_DROP 2    // scanout stopped and the frame buffer freed (not while it's mapped)
+
+// same as struct vga_font in the driver's VgaIoctl.h, glyphs are indexed by Latin-1 code point
+struct vga_font
+{
+    char magic[4];                      // "VGAF"
+    unsigned char height;               // 1-8
+    unsigned char reserved[3];
+    unsigned char width[256];           // 1-8, 0 - no glyph
+    unsigned char rows[256][8];         // bit 7 is the leftmost column
+};
+
+// submission ring, same as struct vga_ring in the driver's VgaIoctl.h
+#define VGA_RING_MMAP_OFFSET 0x80000000
+#define VGA_RING_ENTRIES 256
+#define VGA_RING_CMD_SIZE 248
+
+struct vga_ring_sqe
+{
+    unsigned int tag;
+    unsigned short len;
+    unsigned short reserved;
+    char cmd[VGA_RING_CMD_SIZE];
+};
+
+struct vga_ring_cqe
+{
+    unsigned int tag;
+    int result;                         // 0 or -EINVAL
+};
+
+struct vga_ring
+{
+    unsigned int sq_head, sq_tail, cq_head, cq_tail;
+    unsigned int reserved[12];
+    struct vga_ring_sqe sq[VGA_RING_ENTRIES];
+    struct vga_ring_cqe cq[VGA_RING_ENTRIES];
+};
+
+struct vga
+{
+    int fd;
+    unsigned int* fb;           // frame buffer mapping, NULL if mmap isn't available
+    char submit[VGA_SUBMIT_SIZE];
+    size_t len;                 // bytes queued in submit buffer
+    unsigned long commands, flushes;
+    unsigned int flags;         // vga_open flags
+    struct vga_ring* ring;      // submission ring, NULL until vga_ring_open
+};
+
+int vga_open(struct vga* , const char* , const unsigned int );
+void vga_close(struct vga* );
+int vga_flush(struct vga* );
+int vga_command(struct vga* , const char* );
+
+int vga_text(struct vga* , const unsigned int , const unsigned int , const char* , const bool , const unsigned long , const unsigned long );
+int vga_line(struct vga* , const unsigned int , const unsigned int , const unsigned int , const unsigned int , const unsigned long );
+int vga_rect(struct vga* , const unsigned int , const unsigned int , const unsigned int , const unsigned int , const unsigned long , const bool );
+int vga_circle(struct vga* , const unsigned int , const unsigned int , const unsigned int , const unsigned long , const bool );
+int vga_pix(struct vga* , const unsigned int , const unsigned int , const unsigned long );
+int vga_polygon(struct vga* , const struct Point* , const unsigned int , const unsigned long );
+int vga_triangle(struct vga* , const struct Point , const struct Point , const struct Point , const unsigned long );
+int vga_image(struct vga* , const unsigned int , const unsigned int , const unsigned int , const unsigned int , const unsigned int* );
+int vga_pan(struct vga* , const unsigned int , const bool );
+int vga_blank(struct vga* , const int );
+int vga_font(struct vga* , const struct vga_font* );
+int vga_font_load(struct vga* , const char* );
+int vga_play(struct vga* , const char* );
+
+int vga_ring_open(struct vga* , const bool );
+int vga_ring_submit(struct vga* , const char* , const unsigned int );
+int vga_ring_enter(struct vga* );
+int vga_ring_complete(struct vga* , struct vga_ring_cqe* );
+
+#endif //MSREAL_VGA_DRIVER_APP_INCLUDE_LIBVGA_H_
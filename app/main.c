@@ -1,11 +1,27 @@
 #include "include/app_menu.h"
 #include "include/app_utils.h"
+#include "include/libvga.h"
+#include "include/app_load.h"
 
 #include <stdio.h>
 
-int main(void)
+int main(int argc, char** argv)
 {
+    struct vga vga;
+    if(argc > 1)
+    {
+        struct load_config cfg;
+        if(load_parse_args(argc, argv, &cfg))
+            return 1;
+        return load_run(&cfg);
+    }
+
     printf("Welcome to VGA driver test application!\n");
+    if(vga_open(&vga, VGA_DEVICE, 0))
+    {
+        printf("Could not open %s!\n", VGA_DEVICE);
+        return 1;
+    }
     KeyboardInit();
     
     bool out=false;
@@ -13,8 +29,9 @@ int main(void)
     {
         unsigned int val;
         menu(&val);
-        cases(val, &out);
+        cases(&vga, val, &out);
     }
+    vga_close(&vga);
     printf("Succesfully exited program!\n");
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,279 @@
+#include "../include/app_load.h"
+#include "../include/libvga.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h> //for getopt
+
+#define LINE_SIZE 1024
+
+struct load_command
+{
+    unsigned int kind, x1, y1, x2, y2;
+    unsigned long color;
+    bool flag;              // big text, filled rect or circle
+    const char* word;
+};
+
+struct load_stats
+{
+    double* latency;        // us per write
+    unsigned long writes, capacity;
+    unsigned long sent, failed_writes, dropped;
+};
+
+static void usage(const char* name)
+{
+    printf("usage: %s [-d device] [-f file|-] [-n count] [-t seconds] [-r rate] [-b batch] [-s seed] [-m]\n\
+        without options the interactive menu is started\n\
+        -d device   device to write to (default %s)\n\
+        -f file     stream commands from file, '-' for stdin\n\
+        -n count    number of synthetic random commands (default 10000 when -t isn't given)\n\
+        -t seconds  run for given time\n\
+        -r rate     target commands per second (default as fast as possible)\n\
+        -b batch    commands per write (default 1)\n\
+        -s seed     seed of synthetic command generator\n\
+        -m          let libvga draw synthetic pixels and filled rectangles through mmap\n", name, VGA_DEVICE);
+}
+
+int load_parse_args(int argc, char** argv, struct load_config* cfg)
+{
+    int opt;
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->device = VGA_DEVICE;
+    cfg->batch = 1;
+    cfg->seed = (unsigned int)time(NULL);
+
+    while((opt = getopt(argc, argv, "d:f:n:t:r:b:s:mh")) != -1)
+    {
+        switch(opt)
+        {
+            case 'd': cfg->device = optarg; break;
+            case 'f': cfg->file = optarg; break;
+            case 'n': cfg->count = strtoul(optarg, NULL, 0); break;
+            case 't': cfg->duration = atof(optarg); break;
+            case 'r': cfg->rate = atof(optarg); break;
+            case 'b': cfg->batch = (unsigned int)strtoul(optarg, NULL, 0); break;
+            case 's': cfg->seed = (unsigned int)strtoul(optarg, NULL, 0); break;
+            case 'm': cfg->use_mmap = true; break;
+            default:
+                usage(argv[0]);
+                return -1;
+        }
+    }
+    if(cfg->batch == 0)
+        cfg->batch = 1;
+    if(cfg->file == NULL && cfg->count == 0 && cfg->duration == 0)
+        cfg->count = 10000;
+    return 0;
+}
+
+static inline double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static void pace(const double deadline)
+{
+    struct timespec ts;
+    if(deadline <= now_sec())
+        return;
+    ts.tv_sec = (time_t)deadline;
+    ts.tv_nsec = (long)((deadline - ts.tv_sec)*1e9);
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL));
+}
+
+static void random_command(struct load_command* cmd)
+{
+    static const char* words[] = {"Load", "test", "VGA", "driver", "Zybo", "ok!"};
+    cmd->x1 = rand()%VGA_WIDTH, cmd->y1 = rand()%VGA_HEIGHT;
+    cmd->x2 = rand()%VGA_WIDTH, cmd->y2 = rand()%VGA_HEIGHT;
+    cmd->color = (unsigned long)rand() & 0xffffff;
+    cmd->kind = rand()%5;
+    cmd->flag = rand()&1;
+    cmd->word = words[rand()%6];
+}
+
+// synthetic commands go through the typed calls, so libvga draws pixels and filled rectangles
+// into the mapping when there is one
+static int draw_command(struct vga* vga, const struct load_command* cmd)
+{
+    switch(cmd->kind)
+    {
+        case 0:
+            return vga_text(vga, cmd->x1%(VGA_WIDTH-80), cmd->y1%(VGA_HEIGHT-20), cmd->word, cmd->flag, cmd->color, 0);
+        case 1:
+            return vga_line(vga, cmd->x1, cmd->y1, cmd->x2, cmd->y2, cmd->color);
+        case 2:
+            return vga_rect(vga, cmd->x1, cmd->y1, cmd->x2, cmd->y2, cmd->color, cmd->flag);
+        case 3:
+        {
+            const unsigned int r = 1 + cmd->x2%40;
+            return vga_circle(vga, r + cmd->x1%(VGA_WIDTH-2*r), r + cmd->y1%(VGA_HEIGHT-2*r), r, cmd->color, cmd->flag);
+        }
+        default:
+            return vga_pix(vga, cmd->x1, cmd->y1, cmd->color);
+    }
+}
+
+static int queue_command(struct vga* vga, const char* line, const struct load_command* cmd)
+{
+    errno = 0;
+    return (line != NULL) ? vga_command(vga, line) : draw_command(vga, cmd);
+}
+
+// skips empty lines and '#' comments of command files
+static bool next_command(FILE* fp, char* line, const int size)
+{
+    while(fgets(line, size, fp) != NULL)
+        if(line[0] != '\n' && line[0] != '#')
+            return true;
+    return false;
+}
+
+static void record_write(struct load_stats* stats, const double latency)
+{
+    if(stats->writes == stats->capacity)
+    {
+        double* tmp;
+        stats->capacity = stats->capacity ? 2*stats->capacity : 4096;
+        tmp = realloc(stats->latency, stats->capacity*sizeof(double));
+        if(tmp == NULL)
+        {
+            stats->capacity = stats->writes;
+            return;
+        }
+        stats->latency = tmp;
+    }
+    stats->latency[stats->writes++] = latency;
+}
+
+static void flush_batch(struct vga* vga, struct load_stats* stats, unsigned long* pending)
+{
+    double start;
+    int ret;
+    if(*pending == 0)
+        return;
+    start = now_sec();
+    ret = vga_flush(vga);
+    record_write(stats, (now_sec() - start)*1e6);
+    if(ret)
+    {
+        stats->failed_writes++;
+        stats->dropped += *pending;
+    }
+    else
+        stats->sent += *pending;
+    *pending = 0;
+}
+
+static int compare_double(const void* a, const void* b)
+{
+    const double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const struct load_stats* stats, const double p)
+{
+    unsigned long i;
+    if(stats->writes == 0)
+        return 0;
+    i = (unsigned long)(p*(stats->writes-1) + 0.5);
+    return stats->latency[i];
+}
+
+static void report(struct load_stats* stats, const double elapsed, const unsigned int batch)
+{
+    qsort(stats->latency, stats->writes, sizeof(double), compare_double);
+    printf("commands sent:      %lu in %.3f s\n", stats->sent, elapsed);
+    printf("achieved rate:      %.1f commands/s\n", elapsed > 0 ? stats->sent/elapsed : 0.0);
+    printf("writes:             %lu (batch %u), failed %lu, dropped commands %lu\n",
+        stats->writes, batch, stats->failed_writes, stats->dropped);
+    printf("write latency [us]: p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+        percentile(stats, 0.5), percentile(stats, 0.9), percentile(stats, 0.99), percentile(stats, 0.999),
+        percentile(stats, 1.0));
+}
+
+int load_run(const struct load_config* cfg)
+{
+    struct vga vga;
+    struct load_stats stats = {0};
+    struct load_command cmd;
+    char line[LINE_SIZE];
+    FILE* fp = NULL;
+    unsigned long i, pending = 0;
+    size_t queued;
+    double start, end;
+    int ret;
+
+    // every write is one timed batch, libvga doesn't flush on its own
+    if(vga_open(&vga, cfg->device, VGA_NO_AUTOFLUSH | (cfg->use_mmap ? 0 : VGA_NO_MMAP)))
+    {
+        printf("Could not open %s!\n", cfg->device);
+        return 1;
+    }
+    if(cfg->file != NULL)
+    {
+        fp = strcmp(cfg->file, "-") ? fopen(cfg->file, "r") : stdin;
+        if(fp == NULL)
+        {
+            printf("Could not open %s!\n", cfg->file);
+            vga_close(&vga);
+            return 1;
+        }
+    }
+    srand(cfg->seed);
+
+    start = now_sec();
+    end = start + cfg->duration;
+    for(i=0; cfg->count == 0 || i < cfg->count; ++i)
+    {
+        if(cfg->duration > 0 && now_sec() >= end)
+            break;
+        if(fp != NULL)
+        {
+            if(!next_command(fp, line, sizeof(line)))
+                break;
+        }
+        else
+            random_command(&cmd);
+
+        if(cfg->rate > 0)
+            pace(start + i/cfg->rate);
+        queued = vga.len;
+        ret = queue_command(&vga, fp ? line : NULL, &cmd);
+        if(ret && errno == ENOBUFS)
+        {
+            // the command doesn't fit behind the batch, the batch goes first
+            flush_batch(&vga, &stats, &pending);
+            queued = vga.len;
+            ret = queue_command(&vga, fp ? line : NULL, &cmd);
+        }
+        if(ret)
+        {
+            stats.dropped++;
+            continue;
+        }
+        // drawn straight into the mapping, there is no write to time
+        if(vga.len == queued)
+        {
+            stats.sent++;
+            continue;
+        }
+        if(++pending == cfg->batch)
+            flush_batch(&vga, &stats, &pending);
+    }
+    flush_batch(&vga, &stats, &pending);
+    report(&stats, now_sec() - start, cfg->batch);
+
+    if(fp != NULL && fp != stdin)
+        fclose(fp);
+    vga_close(&vga);
+    free(stats.latency);
+    return stats.failed_writes ? 1 : 0;
+}
@@ -7,6 +7,7 @@
 #include "../include/colors.h"
 #include "../include/app_utils.h"
 #include "../include/Point.h"
+#include "../include/libvga.h"
 
 #define new_line printf("\n")
 #define delay2sec usleep(2000000)
@@ -35,16 +36,16 @@ static inline unsigned long long choose_color(const char* of_what)
     return color_val[tmp-1];
 }
 
-static inline const char* choose_fill(const char* what)
+static inline bool choose_fill(const char* what)
 {
     printf("Do you want to fill the %s?\nPress <Y> or <N>: ", what);
     char tmp=0;
     while(tmp != 'n' && tmp != 'N' && tmp != 'y' && tmp != 'Y')
         tmp = getchar(), new_line;
-    return (tmp == 'n' || tmp == 'N') ? "no" : "fill";
+    return (tmp == 'y' || tmp == 'Y');
 }
 
-static inline void print_character(void)
+static inline void print_character(struct vga* vga)
 {
     char string[BUFF_SIZE]={0};
     unsigned long long char_color=choose_color("character/s"), bckg_color; 
@@ -55,8 +56,8 @@ static inline void print_character(void)
         bool continue_loop=false;
         scanf("%s",string);
         for(i=0;i<strlen(string);++i)
-            if( !(string[i] >= 'a' && string[i] <= 'z') && !(string[i] >= 'A' && string[i] <= 'Z') && string[i] != '!' &&
-                string[i] != ',' && string[i] != ' ' && string[i] != '.' && string[i] != '?')
+            // ';' separates the fields, characters missing from the font are reported by the driver
+            if(string[i] == ';')
             {
                 printf("\nInappropriate character in string!\nTry again: ");
                 continue_loop=true;
@@ -71,39 +72,36 @@ static inline void print_character(void)
     while(tmp != 'S' && tmp != 's' && tmp != 'b' && tmp != 'B')
         tmp = getchar(), new_line;
 
-    const char* font = (tmp == 'S' || tmp == 's') ? "small" : "big";
+    const bool font_big = (tmp != 'S' && tmp != 's');
     struct Point pt = choose_point("character/s");
     bckg_color=choose_color("background");
 
-    char command[BUFF_SIZE*2]={0};
-    sprintf(command,"text;%s;%s;%d;%d;%#04llx;%#04llx\n",string,font,pt.x,pt.y,char_color,bckg_color);
-    sendToDriver(command);
+    vga_text(vga, pt.x, pt.y, string, font_big, char_color, bckg_color);
+    flushToDriver(vga);
     delay2sec;
 }
 
-static inline void print_line(void)
+static inline void print_line(struct vga* vga)
 {
     const struct Point pt1 = choose_point("start of line"), pt2 = choose_point("end of line");
     const unsigned long long line_color = choose_color("line");
-    char command[BUFF_SIZE*2] = {0};
-    sprintf(command,"line;%d;%d;%d;%d;%#04llx\n",pt1.x,pt1.y,pt2.x,pt2.y,line_color);
-    sendToDriver(command);
+    vga_line(vga, pt1.x, pt1.y, pt2.x, pt2.y, line_color);
+    flushToDriver(vga);
     delay2sec;
 }
 
-static inline void print_rectangle(void)
+static inline void print_rectangle(struct vga* vga)
 {
     const struct Point pt1 = choose_point("start of rectangle"), pt2 = choose_point("end of rectangle");
     const unsigned long long rectangle_color = choose_color("rectangle");
     printf("Do you want to fill the rectangle?\nPress <Y> or <N>: ");
-    const char* fill_rectangle = choose_fill("rectangle");
-    char command[BUFF_SIZE*2] = {0};
-    sprintf(command,"rect;%d;%d;%d;%d;%#04llx;%s\n",pt1.x,pt1.y,pt2.x,pt2.y,rectangle_color,fill_rectangle);
-    sendToDriver(command);
+    const bool fill_rectangle = choose_fill("rectangle");
+    vga_rect(vga, pt1.x, pt1.y, pt2.x, pt2.y, rectangle_color, fill_rectangle);
+    flushToDriver(vga);
     delay2sec;
 }
 
-static inline void print_circle(const unsigned int solution)
+static inline void print_circle(struct vga* vga, const unsigned int solution)
 {
     const struct Point pt1 = choose_point("center of circle");
     unsigned int r;
@@ -111,31 +109,30 @@ static inline void print_circle(const unsigned int solution)
     scanf("%d",&r);
     printf("r: %d\n",r);
     const unsigned long long circle_color = choose_color("circle");
-    const char* fill_circle = choose_fill("rectangle");
-    char command[BUFF_SIZE*2] = {0};
-    sprintf(command,"circ;%d;%d;%d;%#04llx;%s\n",pt1.x,pt1.y,r,circle_color,fill_circle);
-    sendToDriver(command);
+    const bool fill_circle = choose_fill("circle");
+    vga_circle(vga, pt1.x, pt1.y, r, circle_color, fill_circle);
+    flushToDriver(vga);
     delay2sec;
 }
 
-void cases(const unsigned int Case, bool* Out)
+void cases(struct vga* vga, const unsigned int Case, bool* Out)
 {
     switch(Case)
     {
         case 1:
-            print_character();
+            print_character(vga);
         break;
 
         case 2:
-            print_line();
+            print_line(vga);
         break;
 
         case 3:
-            print_rectangle();
+            print_rectangle(vga);
         break;
 
         case 4:
-            print_circle(0);
+            print_circle(vga, 0);
         break;
 
         case 5:
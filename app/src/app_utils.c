@@ -1,5 +1,6 @@
 #include "../include/app_utils.h"
 #include "../include/app_menu.h"
+#include "../include/libvga.h"
 
 #include <termios.h> //for termios structure
 #include <unistd.h> //for STDIN_FILENO macro
@@ -23,11 +24,9 @@ void reset_string(char* string)
         string[i] = 0;
 }
 
-void sendToDriver(const char* Command)
+void flushToDriver(struct vga* vga)
 {
-    printf("command sent to driver:\n%s",Command);
-    FILE* fp = fopen("/dev/vga_dma","w");
-    if(fp != NULL)
-        fprintf(fp,"%s",Command);
-    fclose(fp);
+    printf("command sent to driver:\n%.*s", (int)vga->len, vga->submit);
+    if(vga_flush(vga))
+        printf("writing to %s failed!\n", VGA_DEVICE);
 }
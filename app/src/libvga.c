@@ -0,0 +1,328 @@
+#include "../include/libvga.h"
+
+#include <fcntl.h>      //for open
+#include <unistd.h>     //for write, close
+#include <sys/mman.h>   //for mmap, munmap
+#include <sys/ioctl.h>  //for ioctl
+#include <sys/sendfile.h>   //for sendfile
+#include <errno.h>
+#include <stdarg.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define FB_SIZE (VGA_WIDTH*VGA_HEIGHT*sizeof(unsigned int))
+#define VGA_IOC_BLANK _IO('V', 1) // same as in the driver's VgaIoctl.h
+#define VGA_IOC_FONT _IOW('V', 2, struct vga_font)
+#define VGA_IOC_RING_ENTER _IO('V', 3)
+#define VGA_IOC_RING_POLL _IO('V', 4)
+#define RING_SIZE ((sizeof(struct vga_ring) + 4095) & ~4095UL)
+
+int vga_open(struct vga* vga, const char* path, const unsigned int flags)
+{
+    memset(vga, 0, sizeof(*vga));
+    vga->fd = open(path != NULL ? path : VGA_DEVICE, O_RDWR);
+    if(vga->fd < 0)
+        return -1;
+    vga->flags = flags;
+
+    if(!(flags & VGA_NO_MMAP))
+    {
+        void* fb = mmap(NULL, FB_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, vga->fd,
+            (flags & VGA_SHADOW) ? VGA_SHADOW_OFFSET : 0);
+        vga->fb = (fb != MAP_FAILED) ? (unsigned int*)fb : NULL;
+    }
+    return 0;
+}
+
+void vga_close(struct vga* vga)
+{
+    if(vga->fd < 0)
+        return;
+    vga_flush(vga);
+    if(vga->fb != NULL)
+        munmap(vga->fb, FB_SIZE);
+    if(vga->ring != NULL)
+        munmap(vga->ring, RING_SIZE);
+    close(vga->fd);
+    vga->fd = -1;
+    vga->fb = NULL;
+    vga->ring = NULL;
+}
+
+int vga_flush(struct vga* vga)
+{
+    size_t done = 0;
+    while(done < vga->len)
+    {
+        ssize_t ret = write(vga->fd, vga->submit + done, vga->len - done);
+        if(ret < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            vga->len = 0;
+            return -1;
+        }
+        done += ret;
+    }
+    if(vga->len)
+        vga->flushes++;
+    vga->len = 0;
+    return 0;
+}
+
+// queues one command line, the submission buffer goes to the driver only when it is full or on vga_flush
+int vga_command(struct vga* vga, const char* command)
+{
+    size_t len = strlen(command);
+    const bool add_new_line = (len == 0 || command[len-1] != '\n');
+
+    if(len + add_new_line > VGA_SUBMIT_SIZE)
+        return -1;
+    if(vga->len + len + add_new_line > VGA_SUBMIT_SIZE)
+    {
+        if(vga->flags & VGA_NO_AUTOFLUSH)
+        {
+            errno = ENOBUFS;
+            return -1;
+        }
+        if(vga_flush(vga))
+            return -1;
+    }
+
+    memcpy(vga->submit + vga->len, command, len);
+    vga->len += len;
+    if(add_new_line)
+        vga->submit[vga->len++] = '\n';
+    vga->commands++;
+    return 0;
+}
+
+static int vga_commandf(struct vga* vga, const char* format, ...)
+{
+    char command[VGA_SUBMIT_SIZE];
+    va_list args;
+    int len;
+
+    va_start(args, format);
+    len = vsnprintf(command, sizeof(command), format, args);
+    va_end(args);
+    if(len < 0 || len >= (int)sizeof(command))
+        return -1;
+    return vga_command(vga, command);
+}
+
+// direct drawing must not overtake commands which are still waiting in the submission buffer,
+// behind them the primitive is queued as a command too, unless VGA_DIRECT_FLUSH sends them first
+static inline bool direct_draw(struct vga* vga)
+{
+    if(vga->fb == NULL)
+        return false;
+    if(vga->len == 0)
+        return true;
+    if(!(vga->flags & VGA_DIRECT_FLUSH) || (vga->flags & VGA_NO_AUTOFLUSH))
+        return false;
+    return vga_flush(vga) == 0;
+}
+
+int vga_text(struct vga* vga, const unsigned int x, const unsigned int y, const char* string, const bool big_font,
+    const unsigned long color, const unsigned long bckg)
+{
+    return vga_commandf(vga, "text;%s;%s;%u;%u;%#04lx;%#04lx\n", string, big_font ? "big" : "small", x, y, color, bckg);
+}
+
+int vga_line(struct vga* vga, const unsigned int x1, const unsigned int y1, const unsigned int x2, const unsigned int y2,
+    const unsigned long color)
+{
+    return vga_commandf(vga, "line;%u;%u;%u;%u;%#04lx\n", x1, y1, x2, y2, color);
+}
+
+int vga_rect(struct vga* vga, const unsigned int x1, const unsigned int y1, const unsigned int x2, const unsigned int y2,
+    const unsigned long color, const bool fill)
+{
+    if(fill && direct_draw(vga))
+    {
+        unsigned int x, y,
+        startX = (x1 < x2) ? x1 : x2, endX = (x1 < x2) ? x2 : x1,
+        startY = (y1 < y2) ? y1 : y2, endY = (y1 < y2) ? y2 : y1;
+        if(endX >= VGA_WIDTH)
+            endX = VGA_WIDTH-1;
+        if(endY >= VGA_HEIGHT)
+            endY = VGA_HEIGHT-1;
+        for(y=startY; y<=endY; ++y)
+            for(x=startX; x<=endX; ++x)
+                vga->fb[VGA_WIDTH*y + x] = (unsigned int)color;
+        vga->commands++;
+        return 0;
+    }
+    return vga_commandf(vga, "rect;%u;%u;%u;%u;%#04lx;%s\n", x1, y1, x2, y2, color, fill ? "fill" : "no");
+}
+
+int vga_circle(struct vga* vga, const unsigned int x, const unsigned int y, const unsigned int r,
+    const unsigned long color, const bool fill)
+{
+    return vga_commandf(vga, "circ;%u;%u;%u;%#04lx;%s\n", x, y, r, color, fill ? "fill" : "no");
+}
+
+int vga_pix(struct vga* vga, const unsigned int x, const unsigned int y, const unsigned long color)
+{
+    if(x >= VGA_WIDTH || y >= VGA_HEIGHT)
+        return -1;
+    if(direct_draw(vga))
+    {
+        vga->fb[VGA_WIDTH*y + x] = (unsigned int)color;
+        vga->commands++;
+        return 0;
+    }
+    return vga_commandf(vga, "pix;%u;%u;%#04lx\n", x, y, color);
+}
+
+int vga_polygon(struct vga* vga, const struct Point* pts, const unsigned int n, const unsigned long color)
+{
+    char command[VGA_SUBMIT_SIZE];
+    unsigned int i;
+    int len = snprintf(command, sizeof(command), "poly");
+    if(n < 3)
+        return -1;
+    for(i=0; i<n && len < (int)sizeof(command); ++i)
+        len += snprintf(command + len, sizeof(command) - len, ";%u;%u", pts[i].x, pts[i].y);
+    if(len >= (int)sizeof(command))
+        return -1;
+    return vga_commandf(vga, "%s;%#04lx\n", command, color);
+}
+
+int vga_triangle(struct vga* vga, const struct Point a, const struct Point b, const struct Point c, const unsigned long color)
+{
+    return vga_commandf(vga, "tri;%u;%u;%u;%u;%u;%u;%#04lx\n", a.x, a.y, b.x, b.y, c.x, c.y, color);
+}
+
+// sends a w*h block of 0xRRGGBB pixels as an rle image, runs of equal pixels take 4 bytes
+int vga_image(struct vga* vga, const unsigned int x, const unsigned int y, const unsigned int w, const unsigned int h,
+    const unsigned int* pixels)
+{
+    char command[VGA_SUBMIT_SIZE];
+    const size_t n = (size_t)w*h, max_len = VGA_SUBMIT_SIZE - 9; // room for a run and the new line
+    size_t i = 0, len;
+
+    if(w == 0 || h == 0 || vga_commandf(vga, "img;%u;%u;%u;%u;rle\n", x, y, w, h))
+        return -1;
+    while(i < n)
+    {
+        len = snprintf(command, sizeof(command), "img;data;");
+        while(i < n && len < max_len)
+        {
+            const unsigned int color = pixels[i] & 0xffffff;
+            size_t run = 1;
+            while(i + run < n && run < 256 && (pixels[i + run] & 0xffffff) == color)
+                run++;
+            len += snprintf(command + len, sizeof(command) - len, "%02zx%06x", run - 1, color);
+            i += run;
+        }
+        if(vga_command(vga, command))
+            return -1;
+    }
+    return vga_command(vga, "img;end");
+}
+
+// shows the frame buffer from line y on, or with draw set sends the drawing commands there,
+// direct drawing into the mapping isn't moved
+int vga_pan(struct vga* vga, const unsigned int y, const bool draw)
+{
+    return draw ? vga_commandf(vga, "pan;draw;%u\n", y) : vga_commandf(vga, "pan;%u\n", y);
+}
+
+// collected commands are sent first, so they're drawn before the screen goes dark
+int vga_blank(struct vga* vga, const int level)
+{
+    if(vga_flush(vga))
+        return -1;
+    return ioctl(vga->fd, VGA_IOC_BLANK, level);
+}
+
+// sends a command file to the driver without copying it through user space,
+// commands cut between two sendfile chunks are put together by the driver
+int vga_play(struct vga* vga, const char* path)
+{
+    int in, ret = 0;
+    ssize_t sent;
+
+    if(vga_flush(vga))
+        return -1;
+    in = open(path, O_RDONLY);
+    if(in < 0)
+        return -1;
+    while((sent = sendfile(vga->fd, in, NULL, 1 << 20)) != 0)
+        if(sent < 0 && errno != EINTR)
+        {
+            ret = -1;
+            break;
+        }
+    close(in);
+    return ret;
+}
+
+// text already collected is drawn with the old font, NULL goes back to the built-in one
+int vga_font(struct vga* vga, const struct vga_font* font)
+{
+    if(font == NULL)
+        return vga_command(vga, "font;default\n");
+    if(vga_flush(vga))
+        return -1;
+    return ioctl(vga->fd, VGA_IOC_FONT, font);
+}
+
+// the driver reads the font from /lib/firmware/name
+int vga_font_load(struct vga* vga, const char* name)
+{
+    return vga_commandf(vga, "font;load;%s\n", name);
+}
+
+// maps the submission ring, with poll set the driver takes new entries after every frame
+// and vga_ring_enter isn't needed
+int vga_ring_open(struct vga* vga, const bool poll)
+{
+    void* ring = mmap(NULL, RING_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, vga->fd, VGA_RING_MMAP_OFFSET);
+    if(ring == MAP_FAILED)
+        return -1;
+    vga->ring = (struct vga_ring*)ring;
+    return ioctl(vga->fd, VGA_IOC_RING_POLL, poll ? 1 : 0);
+}
+
+// queues one command without a system call, -1 when the ring is full or the command too long
+int vga_ring_submit(struct vga* vga, const char* command, const unsigned int tag)
+{
+    struct vga_ring* ring = vga->ring;
+    const size_t len = strlen(command);
+    const unsigned int tail = ring->sq_tail;
+    struct vga_ring_sqe* sqe;
+
+    if(len > VGA_RING_CMD_SIZE || tail - __atomic_load_n(&ring->sq_head, __ATOMIC_ACQUIRE) >= VGA_RING_ENTRIES)
+        return -1;
+    sqe = &ring->sq[tail % VGA_RING_ENTRIES];
+    sqe->tag = tag;
+    sqe->len = (unsigned short)len;
+    memcpy(sqe->cmd, command, len);
+    // the entry is complete before the driver can see the new tail
+    __atomic_store_n(&ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    vga->commands++;
+    return 0;
+}
+
+// doorbell, returns the number of commands the driver ran
+int vga_ring_enter(struct vga* vga)
+{
+    return ioctl(vga->fd, VGA_IOC_RING_ENTER);
+}
+
+// takes the oldest completion, 0 when there's none (poll() on the descriptor waits for one)
+int vga_ring_complete(struct vga* vga, struct vga_ring_cqe* cqe)
+{
+    struct vga_ring* ring = vga->ring;
+    const unsigned int head = ring->cq_head;
+
+    if(head == __atomic_load_n(&ring->cq_tail, __ATOMIC_ACQUIRE))
+        return 0;
+    *cqe = ring->cq[head % VGA_RING_ENTRIES];
+    __atomic_store_n(&ring->cq_head, head + 1, __ATOMIC_RELEASE);
+    return 1;
+}
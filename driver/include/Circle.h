@@ -9,6 +9,7 @@ struct Circle
 	struct Point pt;
 	unsigned int r;
 	unsigned long long circle_color;
+	u8 circle_alpha;
 	bool fill_circle;
 };
 
@@ -0,0 +1,21 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_COMMIT_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_COMMIT_H_
+
+#include <linux/list.h>
+
+#include "Shape.h"
+
+#define COMMIT_QUEUE_MAX 4096 // queued commands, a fuller queue is applied right away
+
+typedef int commit_mode_t;
+enum {commit_OFF, commit_MANUAL, commit_AUTO};
+
+struct CommitOp
+{
+	struct list_head list;
+	char* line;		// commands that aren't plain drawing (obj, spr, pan, font) are kept as text, NULL otherwise
+	struct Shape shape;
+	struct Box clip;	// clip box of the file that wrote the command
+};
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_COMMIT_H_
@@ -0,0 +1,137 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_DEFERREDIO_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_DEFERREDIO_H_
+
+#include <linux/mm.h>
+#include <linux/pagemap.h>
+#include <linux/rmap.h>
+#include <linux/vmalloc.h>
+#include <linux/bitmap.h>
+#include <linux/workqueue.h>
+#include <linux/jiffies.h>
+
+#include "utils.h"
+
+// mmap at this offset maps a shadow copy of the frame instead of the DMA buffer itself,
+// pages of the shadow are write protected so every page a client writes to is recorded
+#define DEFIO_MMAP_OFFSET 0x40000000
+#define DEFIO_PGOFF (DEFIO_MMAP_OFFSET >> PAGE_SHIFT)
+#define DEFIO_SIZE (640*480*4)
+#define DEFIO_PAGES DIV_ROUND_UP(DEFIO_SIZE, PAGE_SIZE)
+#define DEFIO_ROW_BYTES (640*4)
+
+static unsigned int defio_ms = 20;
+module_param(defio_ms, uint, 0644);
+MODULE_PARM_DESC(defio_ms, "Delay in ms between the first write to the shadow mapping and copying the changed rows to the screen");
+
+static u32* defio_shadow = NULL;
+static DECLARE_BITMAP(defio_pages, DEFIO_PAGES);
+static struct delayed_work defio_work;	// set up by the driver, flushes under its lock
+static unsigned long defio_flushes = 0, defio_rows = 0;
+
+static vm_fault_t defio_fault(struct vm_fault* vmf)
+{
+	const unsigned long offset = (vmf->pgoff - DEFIO_PGOFF) << PAGE_SHIFT;
+	struct page* page;
+	if(offset >= DEFIO_SIZE)
+		return VM_FAULT_SIGBUS;
+	page = vmalloc_to_page((u8*)defio_shadow + offset);
+	if(!page)
+		return VM_FAULT_SIGBUS;
+	get_page(page);
+	// page_mkclean finds the mappings of the page through these
+	if(vmf->vma->vm_file)
+		page->mapping = vmf->vma->vm_file->f_mapping;
+	page->index = vmf->pgoff;
+	vmf->page = page;
+	return 0;
+}
+
+// first write to a clean page, the page stays locked until its pte is writable so a flush
+// can't clean it in between
+static vm_fault_t defio_mkwrite(struct vm_fault* vmf)
+{
+	lock_page(vmf->page);
+	set_bit(vmf->pgoff - DEFIO_PGOFF, defio_pages);
+	schedule_delayed_work(&defio_work, msecs_to_jiffies(defio_ms));
+	return VM_FAULT_LOCKED;
+}
+
+static const struct vm_operations_struct defio_vm_ops =
+{
+	.fault = defio_fault,
+	.page_mkwrite = defio_mkwrite,
+};
+
+static int defio_mmap(struct vm_area_struct* vma)
+{
+	if(vma->vm_end - vma->vm_start > DEFIO_SIZE)
+		return -EINVAL;
+	if(!defio_shadow)
+	{
+		defio_shadow = vmalloc(DEFIO_SIZE);
+		if(!defio_shadow)
+			return -ENOMEM;
+		memcpy(defio_shadow, tx_vir_buffer, DEFIO_SIZE);
+	}
+	vma->vm_ops = &defio_vm_ops;
+	vma->vm_flags |= VM_DONTEXPAND | VM_DONTDUMP;
+	return 0;
+}
+
+// write protects the pages written since the last flush and copies the rows they hold to the screen,
+// a page that is written again during the copy faults and is flushed the next time
+static void defio_flush(void)
+{
+	DECLARE_BITMAP(rows, MAX_H+1);
+	struct Box changed = {0, MAX_H+1, MAX_W, -1};
+	struct Sprite* lifted;
+	unsigned int p, y, n = 0;
+
+	if(!defio_shadow)
+		return;
+	bitmap_zero(rows, MAX_H+1);
+	for(p=0; p<DEFIO_PAGES; ++p)
+	{
+		struct page* page;
+		unsigned int y0, y1;
+		if(!test_and_clear_bit(p, defio_pages))
+			continue;
+		page = vmalloc_to_page((u8*)defio_shadow + p*PAGE_SIZE);
+		lock_page(page);
+		page_mkclean(page);
+		unlock_page(page);
+		y0 = p*PAGE_SIZE/DEFIO_ROW_BYTES;
+		y1 = min_t(unsigned int, ((p+1)*PAGE_SIZE - 1)/DEFIO_ROW_BYTES, MAX_H);
+		bitmap_set(rows, y0, y1 - y0 + 1);
+		changed.y0 = min_t(int, changed.y0, y0);
+		changed.y1 = max_t(int, changed.y1, y1);
+	}
+	if(box_empty(&changed))
+		return;
+	// the shadow doesn't know about sprites, they're put back on top of the new rows
+	lifted = sprites_over(&changed, 1);
+	if(lifted)
+		sprites_lift(lifted);
+	for_each_set_bit(y, rows, MAX_H+1)
+	{
+		pk->copy32(tx_vir_buffer + 640*y, defio_shadow + 640*y, 640);
+		++n;
+	}
+	if(lifted)
+		sprites_drop(&lifted->list);
+	defio_flushes++;
+	defio_rows += n;
+}
+
+static void defio_cleanup(void)
+{
+	unsigned int p;
+	if(!defio_shadow)
+		return;
+	for(p=0; p<DEFIO_PAGES; ++p)
+		vmalloc_to_page((u8*)defio_shadow + p*PAGE_SIZE)->mapping = NULL;
+	vfree(defio_shadow);
+	defio_shadow = NULL;
+}
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_DEFERREDIO_H_
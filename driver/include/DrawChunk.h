@@ -0,0 +1,54 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_DRAWCHUNK_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_DRAWCHUNK_H_
+
+#include <linux/sched.h>
+#include <linux/ktime.h>
+
+// Drawing runs in the writer's thread with the driver lock held, so a big primitive
+// would keep the CPU until it's done. Row loops call draw_yield(): once a chunk of
+// draw_chunk_us has been drawn the CPU is given to a task waiting for it. vga_lock
+// is a mutex, sleeping with it held only makes other writers wait.
+
+#define DRAW_CHUNK_ROWS 16 // rows drawn between two clock reads
+
+static unsigned int draw_chunk_us = 200;
+module_param(draw_chunk_us, uint, 0644);
+MODULE_PARM_DESC(draw_chunk_us, "Drawing time in us between preemption points (0 - primitives run to the end)");
+
+struct DrawChunk
+{
+	u64 start;		// ns, the last preemption point
+	unsigned int rows;	// rows since the clock was read
+};
+
+static struct DrawChunk draw_chunk;	// the thread holding vga_lock
+static unsigned long draw_yields = 0;	// preemption points the lock holder gave the CPU at
+
+// true if the CPU was given away
+static inline bool draw_chunk_yield(struct DrawChunk* chunk)
+{
+	bool yielded = false;
+	u64 now;
+	if(++chunk->rows < DRAW_CHUNK_ROWS || draw_chunk_us == 0)
+		return false;
+	chunk->rows = 0;
+	now = ktime_get_ns();
+	if(now - chunk->start < (u64)draw_chunk_us*1000)
+		return false;
+	if(need_resched())
+	{
+		cond_resched();
+		now = ktime_get_ns();
+		yielded = true;
+	}
+	chunk->start = now;
+	return yielded;
+}
+
+static inline void draw_yield(void)
+{
+	if(draw_chunk_yield(&draw_chunk))
+		draw_yields++;
+}
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_DRAWCHUNK_H_
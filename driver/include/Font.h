@@ -0,0 +1,100 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_FONT_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_FONT_H_
+
+#include <linux/firmware.h>
+
+#include "characters.h"
+#include "GlyphCache.h"
+#include "utils.h"
+
+// Text is drawn with the built-in font or one loaded at run time. A glyph is found by
+// indexing the font with its code point, widths are per glyph so text is proportional.
+
+static char* font_file = NULL;
+module_param(font_file, charp, 0444);
+MODULE_PARM_DESC(font_file, "Font loaded from /lib/firmware at init (struct vga_font), the built-in one when not given");
+
+static struct vga_font font_loaded;
+static const struct vga_font* font_cur = &font_builtin;
+static struct device* font_dev = NULL;
+
+// kept text is laid out again after a font change, defined in commands.h
+static void font_changed(void);
+
+// checks the font and makes a copy of it the current one, bits outside a glyph are cleared
+static int font_set(const struct vga_font* font)
+{
+	unsigned int i, j;
+	if(memcmp(font->magic, VGA_FONT_MAGIC, sizeof(font->magic)) || font->height == 0 || font->height > VGA_FONT_MAX_H)
+	{
+		printk(KERN_ERR "VGA_DMA: font has a wrong magic or height %u\n", font->height);
+		return -EINVAL;
+	}
+	for(i=0; i<VGA_FONT_GLYPHS; ++i)
+		if(font->width[i] > VGA_FONT_MAX_W)
+		{
+			printk(KERN_ERR "VGA_DMA: glyph 0x%02x of the font is %u columns wide\n", i, font->width[i]);
+			return -EINVAL;
+		}
+	font_loaded = *font;
+	for(i=0; i<VGA_FONT_GLYPHS; ++i)
+		for(j=0; j<VGA_FONT_MAX_H; ++j)
+			font_loaded.rows[i][j] = (j < font_loaded.height) ? font_loaded.rows[i][j] & (u8)(0xff << (8 - font_loaded.width[i])) : 0;
+	font_cur = &font_loaded;
+	// tiles of the old font would be drawn for the same characters
+	glyph_cache_clear();
+	font_changed();
+	return 0;
+}
+
+static void font_default(void)
+{
+	font_cur = &font_builtin;
+	glyph_cache_clear();
+	font_changed();
+}
+
+// the file is looked up in /lib/firmware only, no user space helper is waited for
+static int font_load(const char* name)
+{
+	const struct firmware* fw;
+	int ret = request_firmware_direct(&fw, name, font_dev);
+	if(ret)
+	{
+		printk(KERN_ERR "VGA_DMA: could not load font %s (%d)\n", name, ret);
+		return ret;
+	}
+	if(fw->size != sizeof(struct vga_font))
+	{
+		printk(KERN_ERR "VGA_DMA: font %s is %zu bytes, expected %zu\n", name, fw->size, sizeof(struct vga_font));
+		ret = -EINVAL;
+	}
+	else
+		ret = font_set((const struct vga_font*)fw->data);
+	release_firmware(fw);
+	return ret;
+}
+
+static void font_init(struct device* dev)
+{
+	font_dev = dev;
+	if(font_file && font_file[0] && font_load(font_file))
+		printk(KERN_WARNING "VGA_DMA: continuing with the built-in font\n");
+}
+
+// font;load;NAME  - the font is read from /lib/firmware/NAME
+// font;default    - back to the built-in font
+static int font_command(const char* const* commands)
+{
+	if(!strcmp(commands[1],"default") || !strcmp(commands[1],"DEFAULT"))
+	{
+		font_default();
+		return 0;
+	}
+	if((!strcmp(commands[1],"load") || !strcmp(commands[1],"LOAD")) && commands[2][0])
+		return font_load(commands[2]) ? -1 : 0;
+	printk(KERN_ERR "VGA_DMA: %s this is not appropriate font command\n", commands[1]);
+	return -1;
+}
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_FONT_H_
@@ -0,0 +1,32 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_GCONTEXT_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_GCONTEXT_H_
+
+#include "utils.h"
+#include "Image.h"
+#include "Commit.h"
+
+#define GC_COORD_SIZE 12 // "-2147483648"
+
+struct VgaRing;
+struct VgaStream;
+
+// drawing state of one open file, commands which leave out colors or the font take them from here
+struct GContext
+{
+	char pen[BUFF_SIZE];	// COLOR[@ALPHA] of lines, outlines, pixels and text
+	char fill[BUFF_SIZE];	// COLOR[@ALPHA] of filled shapes and the text background
+	bool big_font;
+	bool anti_alias;
+	int ox, oy;		// origin, added to every coordinate
+	struct Box clip;	// ordinary drawing commands of the file stay inside this area
+	struct Image image;	// upload in progress
+	char coords[CMD_FIELDS][GC_COORD_SIZE];	// coordinates moved to the origin, fields of the current command point here
+	struct VgaRing* ring;	// submission ring of the file, NULL until it's mapped
+	struct VgaStream* stream;	// unfinished command of splice/sendfile input, NULL until the first one
+	commit_mode_t commit_mode;	// set with commit;MODE, only this file's commands are queued
+	struct list_head commit_queue;	// commands of the batch being written
+	unsigned int commit_queued;
+	struct list_head list;	// in gc_files
+};
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_GCONTEXT_H_
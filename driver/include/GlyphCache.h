@@ -0,0 +1,95 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_GLYPHCACHE_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_GLYPHCACHE_H_
+
+#include <linux/list.h>
+#include <linux/hashtable.h>
+#include <linux/jhash.h>
+
+#include "Word.h"
+
+// Opaque text keeps its rendered glyphs: a glyph drawn again with the same font and colors
+// is copied row by row from the cache instead of being built from the bool forms.
+// The least recently drawn glyph makes room when the cache is full.
+
+#define GLYPH_CACHE_BITS 6
+
+static unsigned int glyph_cache = 128;
+module_param(glyph_cache, uint, 0644);
+MODULE_PARM_DESC(glyph_cache, "Rendered glyphs of opaque text kept for reuse (0 - no cache)");
+
+struct GlyphTile
+{
+	struct hlist_node node;		// lookup by character, font and colors
+	struct list_head lru;		// the most recently drawn glyph is first
+	u8 character;
+	bool big_font;
+	u32 fg, bg;
+	u32 px[BIG_FONT_H][BIG_FONT_W+1];	// glyph rows with the spacing column
+};
+
+static DEFINE_HASHTABLE(glyph_ids, GLYPH_CACHE_BITS);
+static LIST_HEAD(glyph_lru);
+static unsigned int glyph_count = 0;
+static unsigned long glyph_hits = 0, glyph_misses = 0;
+
+static inline u32 glyph_key(const u8 character, const bool big_font, const u32 fg, const u32 bg)
+{
+	return jhash_3words(character | (big_font << 8), fg, bg, 0);
+}
+
+static struct GlyphTile* glyph_cache_find(const u8 character, const bool big_font, const u32 fg, const u32 bg)
+{
+	struct GlyphTile* tile;
+	hash_for_each_possible(glyph_ids, tile, node, glyph_key(character, big_font, fg, bg))
+		if(tile->character == character && tile->big_font == big_font && tile->fg == fg && tile->bg == bg)
+		{
+			list_move(&tile->lru, &glyph_lru);
+			glyph_hits++;
+			return tile;
+		}
+	glyph_misses++;
+	return NULL;
+}
+
+static void glyph_cache_evict(struct GlyphTile* tile)
+{
+	hash_del(&tile->node);
+	list_del(&tile->lru);
+	glyph_count--;
+	kfree(tile);
+}
+
+// renders the glyph mask (1 - background) into a new tile, NULL when caching is off or there's no memory
+static struct GlyphTile* glyph_cache_add(const u8 character, const bool big_font, const u32 fg, const u32 bg,
+	const u8 (*mask)[BIG_FONT_W+1], const unsigned int w, const unsigned int h)
+{
+	struct GlyphTile* tile;
+	unsigned int i;
+
+	if(glyph_cache == 0)
+		return NULL;
+	// glyph_cache can be lowered at run time
+	while(glyph_count >= glyph_cache)
+		glyph_cache_evict(list_last_entry(&glyph_lru, struct GlyphTile, lru));
+	tile = kmalloc(sizeof(*tile), GFP_KERNEL);
+	if(!tile)
+		return NULL;
+	tile->character = character;
+	tile->big_font = big_font;
+	tile->fg = fg, tile->bg = bg;
+	for(i=0; i<h; ++i)
+		pk->expand32(tile->px[i], mask[i], w, bg, fg);
+	hash_add(glyph_ids, &tile->node, glyph_key(character, big_font, fg, bg));
+	list_add(&tile->lru, &glyph_lru);
+	glyph_count++;
+	return tile;
+}
+
+static void glyph_cache_clear(void)
+{
+	struct GlyphTile *tile, *tmp;
+	list_for_each_entry_safe(tile, tmp, &glyph_lru, lru)
+		glyph_cache_evict(tile);
+}
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_GLYPHCACHE_H_
@@ -0,0 +1,28 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_IMAGE_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_IMAGE_H_
+
+#include "utils.h"
+
+#define IMAGE_PALETTE_SIZE 256
+
+typedef int image_format_t;
+enum {image_RLE, image_RLE8, image_PAL8, image_PAL4};
+
+// image being uploaded, its bytes are decoded into the frame as they arrive
+struct Image
+{
+	bool active;
+	image_format_t format;
+	int x, y, w;			// top left corner on the screen and width
+	struct Box area;		// part of the image that is drawn, inside the clip box
+	unsigned int pos, pixels;	// first pixel not written yet, w*h
+	u32 palette[IMAGE_PALETTE_SIZE];
+	unsigned int colors;
+	u8 rec[4];			// bytes of an unfinished run record
+	unsigned int nrec;
+	int nibble;			// high hex digit of a byte split between two data commands, -1 none
+	u32 run_color;			// equal pixels are collected and written as one span
+	unsigned int run_len;
+};
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_IMAGE_H_
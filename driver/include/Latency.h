@@ -0,0 +1,74 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_LATENCY_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_LATENCY_H_
+
+#include <linux/percpu.h>
+#include <linux/log2.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+
+#include "utils.h"
+
+// Per command type log2 histograms of the time from parsing to drawing, per CPU so counting
+// costs one local increment. /sys/kernel/debug/vga_dma/latency shows the sums over all CPUs.
+
+#define LATENCY_BUCKETS 32 // bucket i counts [2^i, 2^(i+1)) ns, the last one also everything longer
+
+struct LatencyHist
+{
+	unsigned long count[state_ERR][LATENCY_BUCKETS];
+};
+
+static DEFINE_PER_CPU(struct LatencyHist, latency_hist);
+static struct dentry* vga_debugfs;
+
+static inline void latency_add(const state_t state, const u64 ns)
+{
+	const unsigned int b = ns ? min_t(unsigned int, ilog2(ns), LATENCY_BUCKETS-1) : 0;
+	if(state >= 0 && state < state_ERR)
+		this_cpu_inc(latency_hist.count[state][b]);
+}
+
+static int latency_show(struct seq_file* s, void* unused)
+{
+	unsigned long sum[LATENCY_BUCKETS], total;
+	unsigned int i, b;
+	int cpu;
+	for(i=0; i<ARRAY_SIZE(keywords); ++i)
+	{
+		const state_t state = keywords[i].state;
+		total = 0;
+		for(b=0; b<LATENCY_BUCKETS; ++b)
+		{
+			sum[b] = 0;
+			for_each_possible_cpu(cpu)
+				sum[b] += per_cpu_ptr(&latency_hist, cpu)->count[state][b];
+			total += sum[b];
+		}
+		if(!total)
+			continue;
+		seq_printf(s, "%s: %lu commands\n", keywords[i].lower, total);
+		for(b=0; b<LATENCY_BUCKETS; ++b)
+			if(sum[b])
+				seq_printf(s, "  >= %10llu ns: %lu\n", b ? 1ULL << b : 0, sum[b]);
+	}
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(latency);
+
+static void vga_debugfs_init(void)
+{
+	vga_debugfs = debugfs_create_dir("vga_dma", NULL);
+	debugfs_create_file("latency", 0444, vga_debugfs, NULL, &latency_fops);
+	overdraw_debugfs_init(vga_debugfs);
+	debugfs_create_ulong("glyph_hits", 0444, vga_debugfs, &glyph_hits);
+	debugfs_create_ulong("glyph_misses", 0444, vga_debugfs, &glyph_misses);
+	debugfs_create_ulong("draw_yields", 0444, vga_debugfs, &draw_yields);
+}
+
+static void vga_debugfs_exit(void)
+{
+	debugfs_remove_recursive(vga_debugfs);
+	overdraw_exit();
+}
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_LATENCY_H_
@@ -8,6 +8,7 @@ struct Line
 {
 	struct Point pt1, pt2;
 	unsigned long long line_color;
+	u8 line_alpha;
 };
 
 #endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_LINE_H_
@@ -0,0 +1,323 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_OVERDRAW_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_OVERDRAW_H_
+
+#include <linux/vmalloc.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/atomic.h>
+#include <linux/mutex.h>
+
+// Overdraw measurement: while it's on the pixel kernels are wrapped by ones that count every
+// pixel written to the frame, put_pixel counts its pixels too. A frame is what's drawn between
+// two DMA frames, frames without drawing don't count.
+// echo on|off|clear > /sys/kernel/debug/vga_dma/overdraw, cat it for the numbers,
+// /sys/kernel/debug/vga_dma/overdraw.ppm is the heatmap of the writes since the last clear.
+// The fb hooks count without vga_lock and raster bands count in parallel, so the pixels are atomic.
+
+#define OVERDRAW_PIXELS (640*(MAX_H+1))
+#define OVERDRAW_BLOCK 8
+#define OVERDRAW_TOP 8 // hottest blocks shown
+
+struct OverdrawPixel
+{
+	atomic_t frame;	// last frame the pixel was written in
+	atomic_t writes;	// since the last clear
+};
+
+static bool overdraw_on;
+static struct OverdrawPixel* overdraw_map;
+static const struct PixelKernels* overdraw_real;
+static DEFINE_MUTEX(overdraw_lock);
+static u32 overdraw_frame = 1;
+static atomic_long_t overdraw_writes, overdraw_pixels, overdraw_frame_writes, overdraw_frame_pixels;
+static unsigned long overdraw_frames, overdraw_last_writes, overdraw_last_pixels;
+
+// off is the pixel in the 480 lines drawn to, the heatmap follows pan;draw
+static void overdraw_add_at(const long off, const unsigned int n)
+{
+	const u32 frame = READ_ONCE(overdraw_frame);
+	struct OverdrawPixel* p;
+	unsigned int i, fresh = 0, in_frame = 0;
+	int last;
+
+	if(off < 0 || off + n > OVERDRAW_PIXELS)
+		return;
+	for(i=0, p=overdraw_map+off; i<n; ++i, ++p)
+	{
+		if(atomic_inc_return(&p->writes) == 1)
+			fresh++;
+		// only the writer that moves the pixel to this frame counts it
+		last = atomic_read(&p->frame);
+		if(last != (int)frame && atomic_cmpxchg(&p->frame, last, frame) == last)
+			in_frame++;
+	}
+	atomic_long_add(n, &overdraw_writes);
+	atomic_long_add(fresh, &overdraw_pixels);
+	atomic_long_add(n, &overdraw_frame_writes);
+	atomic_long_add(in_frame, &overdraw_frame_pixels);
+}
+
+// pixels outside the frame (sprite save buffers) aren't counted, a tile being drawn
+// counts where it'll end up
+static inline void overdraw_add(const u32* dst, const unsigned int n)
+{
+	const u32* base = draw_tile ? draw_tile : tx_vir_buffer;
+	overdraw_add_at((long)((unsigned long)dst - (unsigned long)base) / (long)sizeof(u32) + (draw_tile ? 640*draw_tile_y0 : 0), n);
+}
+
+static void overdraw_fill32(u32* dst, const u32 color, unsigned int n)
+{
+	overdraw_add(dst, n);
+	overdraw_real->fill32(dst, color, n);
+}
+
+static void overdraw_copy32(u32* dst, const u32* src, unsigned int n)
+{
+	overdraw_add(dst, n);
+	overdraw_real->copy32(dst, src, n);
+}
+
+static void overdraw_expand32(u32* dst, const u8* mask, unsigned int n, const u32 on, const u32 off)
+{
+	overdraw_add(dst, n);
+	overdraw_real->expand32(dst, mask, n, on, off);
+}
+
+static void overdraw_blend32(u32* dst, const u32 color, unsigned int n, const u32 alpha)
+{
+	overdraw_add(dst, n);
+	overdraw_real->blend32(dst, color, n, alpha);
+}
+
+static void overdraw_blendcopy32(u32* dst, const u32* src, unsigned int n, const u32 alpha)
+{
+	overdraw_add(dst, n);
+	overdraw_real->blendcopy32(dst, src, n, alpha);
+}
+
+static void overdraw_blendmask32(u32* dst, const u8* coverage, unsigned int n, const u32 color, const u32 alpha)
+{
+	overdraw_add(dst, n);
+	overdraw_real->blendmask32(dst, coverage, n, color, alpha);
+}
+
+static const struct PixelKernels overdraw_kernels =
+{
+	.name = "overdraw",
+	.fill32 = overdraw_fill32,
+	.copy32 = overdraw_copy32,
+	.expand32 = overdraw_expand32,
+	.blend32 = overdraw_blend32,
+	.blendcopy32 = overdraw_blendcopy32,
+	.blendmask32 = overdraw_blendmask32,
+};
+
+// the kernels under the wrappers, for copies that move pixels already counted
+static inline const struct PixelKernels* pk_uncounted(void)
+{
+	const struct PixelKernels* k = READ_ONCE(pk);
+	return (k == &overdraw_kernels) ? overdraw_real : k;
+}
+
+// called from the DMA interrupt when a frame went out
+static inline void overdraw_frame_done(void)
+{
+	long writes;
+	if(!READ_ONCE(overdraw_on))
+		return;
+	writes = atomic_long_xchg(&overdraw_frame_writes, 0);
+	if(!writes)
+		return;
+	overdraw_last_writes = writes;
+	overdraw_last_pixels = atomic_long_xchg(&overdraw_frame_pixels, 0);
+	overdraw_frames++;
+	WRITE_ONCE(overdraw_frame, overdraw_frame + 1);
+}
+
+static void overdraw_clear(void)
+{
+	memset(overdraw_map, 0, OVERDRAW_PIXELS*sizeof(*overdraw_map));
+	atomic_long_set(&overdraw_writes, 0);
+	atomic_long_set(&overdraw_pixels, 0);
+	atomic_long_set(&overdraw_frame_writes, 0);
+	atomic_long_set(&overdraw_frame_pixels, 0);
+	overdraw_frames = 0, overdraw_last_writes = 0, overdraw_last_pixels = 0;
+	overdraw_frame = 1;
+}
+
+// the map stays allocated until the module goes away, so a kernel call that
+// started just before overdraw was turned off never writes to freed memory
+static int overdraw_enable(const bool on)
+{
+	if(on == overdraw_on)
+		return 0;
+	if(on)
+	{
+		if(!overdraw_map && !(overdraw_map = vmalloc(OVERDRAW_PIXELS*sizeof(*overdraw_map))))
+			return -ENOMEM;
+		overdraw_clear();
+		overdraw_real = pk;
+		WRITE_ONCE(pk, &overdraw_kernels);
+	}
+	else
+		WRITE_ONCE(pk, overdraw_real);
+	WRITE_ONCE(overdraw_on, on);
+	printk(KERN_INFO "vga_dma: overdraw counting %s\n", on ? "on" : "off");
+	return 0;
+}
+
+// writes per written pixel, two decimals
+static void overdraw_ratio(struct seq_file* s, const char* what, const unsigned long writes, const unsigned long pixels)
+{
+	const unsigned long r = pixels ? writes*100 / pixels : 0;
+	seq_printf(s, "%s: %lu writes, %lu pixels, %lu.%02lu writes per pixel\n", what, writes, pixels, r / 100, r % 100);
+}
+
+static int overdraw_show(struct seq_file* s, void* unused)
+{
+	unsigned long* blocks;
+	unsigned int top[OVERDRAW_TOP], ntop = 0, i, j, b;
+	const unsigned int bw = 640/OVERDRAW_BLOCK, nblocks = bw*((MAX_H+1)/OVERDRAW_BLOCK);
+
+	mutex_lock(&overdraw_lock);
+	seq_printf(s, "counting: %s\n", overdraw_on ? "on" : "off");
+	if(!overdraw_map)
+		goto out;
+	seq_printf(s, "frames: %lu\n", overdraw_frames);
+	overdraw_ratio(s, "since clear", atomic_long_read(&overdraw_writes), atomic_long_read(&overdraw_pixels));
+	overdraw_ratio(s, "last frame", overdraw_last_writes, overdraw_last_pixels);
+
+	blocks = kcalloc(nblocks, sizeof(*blocks), GFP_KERNEL);
+	if(!blocks)
+		goto out;
+	for(i=0; i<OVERDRAW_PIXELS; ++i)
+		blocks[(i/640/OVERDRAW_BLOCK)*bw + (i%640)/OVERDRAW_BLOCK] += (u32)atomic_read(&overdraw_map[i].writes);
+	// the hottest blocks, most writes first
+	for(b=0; b<nblocks; ++b)
+	{
+		if(!blocks[b] || (ntop == OVERDRAW_TOP && blocks[b] <= blocks[top[ntop-1]]))
+			continue;
+		if(ntop < OVERDRAW_TOP)
+			ntop++;
+		for(j=ntop-1; j>0 && blocks[top[j-1]] < blocks[b]; --j)
+			top[j] = top[j-1];
+		top[j] = b;
+	}
+	for(j=0; j<ntop; ++j)
+		seq_printf(s, "block %3u;%3u: %lu writes, %lu per pixel\n", (top[j]%bw)*OVERDRAW_BLOCK, (top[j]/bw)*OVERDRAW_BLOCK,
+			blocks[top[j]], blocks[top[j]] / (OVERDRAW_BLOCK*OVERDRAW_BLOCK));
+	kfree(blocks);
+out:
+	mutex_unlock(&overdraw_lock);
+	return 0;
+}
+
+static int overdraw_open(struct inode* inode, struct file* file)
+{
+	return single_open(file, overdraw_show, NULL);
+}
+
+static ssize_t overdraw_write(struct file* file, const char __user* buf, size_t len, loff_t* off)
+{
+	char cmd[8];
+	int ret = 0;
+	if(len >= sizeof(cmd))
+		return -EINVAL;
+	if(copy_from_user(cmd, buf, len))
+		return -EFAULT;
+	cmd[len] = '\0';
+	strim(cmd);
+	mutex_lock(&overdraw_lock);
+	if(!strcmp(cmd, "on") || !strcmp(cmd, "1"))
+		ret = overdraw_enable(true);
+	else if(!strcmp(cmd, "off") || !strcmp(cmd, "0"))
+		ret = overdraw_enable(false);
+	else if(!strcmp(cmd, "clear") && overdraw_map)
+		overdraw_clear();
+	else
+		ret = -EINVAL;
+	mutex_unlock(&overdraw_lock);
+	return ret ? ret : len;
+}
+
+static const struct file_operations overdraw_fops =
+{
+	.owner = THIS_MODULE,
+	.open = overdraw_open,
+	.read = seq_read,
+	.write = overdraw_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+// heatmap colors for 0, 1, 2, 3, 4, 5-7 and 8 or more writes
+static const u32 overdraw_ramp[] = {0x000000, 0x0000a0, 0x00a000, 0xc0c000, 0xff8000, 0xff0000, 0xffffff};
+
+struct OverdrawImage
+{
+	size_t size;
+	u8 data[];
+};
+
+// binary PPM of the frame, the picture is taken when the file is opened
+static int overdraw_ppm_open(struct inode* inode, struct file* file)
+{
+	const int head = 15; // "P6\n640 480\n255\n"
+	struct OverdrawImage* img;
+	unsigned int i, w;
+	u8* px;
+
+	if(!overdraw_map)
+		return -ENODATA;
+	img = vmalloc(sizeof(*img) + head + OVERDRAW_PIXELS*3);
+	if(!img)
+		return -ENOMEM;
+	img->size = head + OVERDRAW_PIXELS*3;
+	memcpy(img->data, "P6\n640 480\n255\n", head);
+	px = img->data + head;
+	for(i=0; i<OVERDRAW_PIXELS; ++i, px+=3)
+	{
+		w = atomic_read(&overdraw_map[i].writes);
+		w = w >= 8 ? 6 : w >= 5 ? 5 : w;
+		px[0] = overdraw_ramp[w] >> 16, px[1] = overdraw_ramp[w] >> 8, px[2] = overdraw_ramp[w];
+	}
+	file->private_data = img;
+	return 0;
+}
+
+static ssize_t overdraw_ppm_read(struct file* file, char __user* buf, size_t len, loff_t* off)
+{
+	const struct OverdrawImage* img = file->private_data;
+	return simple_read_from_buffer(buf, len, off, img->data, img->size);
+}
+
+static int overdraw_ppm_release(struct inode* inode, struct file* file)
+{
+	vfree(file->private_data);
+	return 0;
+}
+
+static const struct file_operations overdraw_ppm_fops =
+{
+	.owner = THIS_MODULE,
+	.open = overdraw_ppm_open,
+	.read = overdraw_ppm_read,
+	.llseek = default_llseek,
+	.release = overdraw_ppm_release,
+};
+
+static void overdraw_debugfs_init(struct dentry* dir)
+{
+	debugfs_create_file("overdraw", 0644, dir, NULL, &overdraw_fops);
+	debugfs_create_file("overdraw.ppm", 0444, dir, NULL, &overdraw_ppm_fops);
+}
+
+static void overdraw_exit(void)
+{
+	mutex_lock(&overdraw_lock);
+	overdraw_enable(false);
+	mutex_unlock(&overdraw_lock);
+	vfree(overdraw_map);
+}
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_OVERDRAW_H_
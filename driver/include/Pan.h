@@ -0,0 +1,68 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_PAN_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_PAN_H_
+
+#include "utils.h"
+
+// The frame buffer can hold more lines than the screen. The DMA reads the 480 lines from
+// pan_y on, so scrolling and switching between pages drawn in advance only change the
+// start address programmed at the next frame interrupt, no pixel is copied.
+
+#define PAN_MAX_LINES (4*(MAX_H+1))
+
+static unsigned int virtual_lines = MAX_H+1;
+module_param(virtual_lines, uint, 0444);
+MODULE_PARM_DESC(virtual_lines, "Lines of the frame buffer (480-1920), the screen shows 480 of them from the pan line on");
+
+static u32* vga_base = NULL;		// line 0 of the frame buffer, tx_vir_buffer is the first line drawn to
+static unsigned int pan_y = 0;		// first line on the screen, read by dma_isr
+
+// checks virtual_lines, returns the size of the frame buffer in bytes
+static size_t pan_size(void)
+{
+	if(virtual_lines < MAX_H+1 || virtual_lines > PAN_MAX_LINES)
+	{
+		printk(KERN_WARNING "VGA_DMA: virtual_lines %u is out of range, using %u\n", virtual_lines, clamp_t(unsigned int, virtual_lines, MAX_H+1, PAN_MAX_LINES));
+		virtual_lines = clamp_t(unsigned int, virtual_lines, MAX_H+1, PAN_MAX_LINES);
+	}
+	return (size_t)640*4*virtual_lines;
+}
+
+static void pan_init(u32* base)
+{
+	vga_base = base;
+	tx_vir_buffer = base;
+	pan_y = 0;
+}
+
+// byte offset of the first line on the screen
+static inline u32 pan_offset(void)
+{
+	return READ_ONCE(pan_y)*640*4;
+}
+
+static int pan_check(const unsigned int y)
+{
+	if(y > virtual_lines - (MAX_H+1))
+	{
+		printk(KERN_ERR "VGA_DMA: %u is not appropriate pan line, the frame buffer has %u lines\n", y, virtual_lines);
+		return -1;
+	}
+	return 0;
+}
+
+// pan;Y       - the screen shows lines Y..Y+479 from the next frame on
+// pan;draw;Y  - drawing commands, the scene, sprites and the shadow mapping go to lines Y..Y+479
+static int pan_command(const char* const* commands)
+{
+	const bool draw = !strcmp(commands[1],"draw") || !strcmp(commands[1],"DRAW");
+	unsigned int y;
+	if(strToInt(commands[draw ? 2 : 1], &y) || pan_check(y))
+		return -1;
+	if(draw)
+		tx_vir_buffer = vga_base + 640*y;
+	else
+		WRITE_ONCE(pan_y, y);
+	return 0;
+}
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_PAN_H_
@@ -0,0 +1,14 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_PIX_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_PIX_H_
+
+#include "utils.h"
+#include "Point.h"
+
+struct Pix
+{
+	struct Point pt;
+	unsigned long long pix_color;
+	u8 pix_alpha;
+};
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_PIX_H_
@@ -0,0 +1,615 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_PIXELKERNELS_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_PIXELKERNELS_H_
+
+// Row kernels every rasterizer ends up in. Scalar versions are the reference,
+// SIMD versions are picked at load time (module parameter pixel_kernels=auto|scalar|neon|sse2)
+// and only if they give the same output as the scalar ones on the self-test.
+// Building with "make PIXEL_KERNELS=scalar" leaves the SIMD versions out.
+
+#if !defined(PK_SCALAR_ONLY) && defined(CONFIG_ARM) && defined(CONFIG_KERNEL_MODE_NEON)
+#define PK_HAVE_NEON
+#include <asm/neon.h>
+#include <asm/hwcap.h>
+#elif !defined(PK_SCALAR_ONLY) && defined(CONFIG_X86)
+#define PK_HAVE_SSE2
+#include <asm/fpu/api.h>
+#include <asm/cpufeature.h>
+#endif
+
+// below this many pixels saving the SIMD register file costs more than it gives
+#define PK_SIMD_MIN_PIXELS 16
+
+struct PixelKernels
+{
+	const char* name;
+	// dst[0..n) = color
+	void (*fill32)(u32* dst, const u32 color, unsigned int n);
+	// dst[0..n) = src[0..n), buffers don't overlap
+	void (*copy32)(u32* dst, const u32* src, unsigned int n);
+	// dst[i] = mask[i] ? on : off
+	void (*expand32)(u32* dst, const u8* mask, unsigned int n, const u32 on, const u32 off);
+	// dst = color over dst with alpha 0-255, every byte of the pixel is blended the same way
+	void (*blend32)(u32* dst, const u32 color, unsigned int n, const u32 alpha);
+	// dst = src over dst with alpha 0-255, buffers don't overlap
+	void (*blendcopy32)(u32* dst, const u32* src, unsigned int n, const u32 alpha);
+	// dst = color over dst with alpha*coverage[i]/255 (anti-aliased glyph rows)
+	void (*blendmask32)(u32* dst, const u8* coverage, unsigned int n, const u32 color, const u32 alpha);
+};
+
+// round(a*b/255) without a division
+static inline u32 mul255(const u32 a, const u32 b)
+{
+	const u32 t = a*b + 128;
+	return (t + (t >> 8)) >> 8;
+}
+
+// round((s*a + d*(255-a))/255) on all four bytes, two bytes per multiply;
+// every SIMD variant rounds exactly like this
+static inline u32 blend_pixel32(const u32 s, const u32 d, const u32 a)
+{
+	u32 rb = (s & 0x00ff00ff)*a + (d & 0x00ff00ff)*(255-a) + 0x00800080;
+	u32 ag = ((s >> 8) & 0x00ff00ff)*a + ((d >> 8) & 0x00ff00ff)*(255-a) + 0x00800080;
+	rb = ((rb + ((rb >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+	ag = (ag + ((ag >> 8) & 0x00ff00ff)) & 0xff00ff00;
+	return rb | ag;
+}
+
+static void scalar_fill32(u32* dst, const u32 color, unsigned int n)
+{
+	while(n--)
+		*dst++ = color;
+}
+
+static void scalar_copy32(u32* dst, const u32* src, unsigned int n)
+{
+	while(n--)
+		*dst++ = *src++;
+}
+
+static void scalar_expand32(u32* dst, const u8* mask, unsigned int n, const u32 on, const u32 off)
+{
+	while(n--)
+		*dst++ = *mask++ ? on : off;
+}
+
+static void scalar_blend32(u32* dst, const u32 color, unsigned int n, const u32 alpha)
+{
+	for(; n--; ++dst)
+		*dst = blend_pixel32(color, *dst, alpha);
+}
+
+static void scalar_blendcopy32(u32* dst, const u32* src, unsigned int n, const u32 alpha)
+{
+	for(; n--; ++dst)
+		*dst = blend_pixel32(*src++, *dst, alpha);
+}
+
+static void scalar_blendmask32(u32* dst, const u8* coverage, unsigned int n, const u32 color, const u32 alpha)
+{
+	for(; n--; ++dst)
+	{
+		const u32 a = mul255(*coverage++, alpha);
+		if(a == 255)
+			*dst = color;
+		else if(a)
+			*dst = blend_pixel32(color, *dst, a);
+	}
+}
+
+static const struct PixelKernels scalar_kernels =
+{
+	"scalar", scalar_fill32, scalar_copy32, scalar_expand32,
+	scalar_blend32, scalar_blendcopy32, scalar_blendmask32
+};
+
+#ifdef PK_HAVE_NEON
+static void neon_fill32(u32* dst, const u32 color, unsigned int n)
+{
+	unsigned int blocks;
+	if(n < PK_SIMD_MIN_PIXELS)
+	{
+		scalar_fill32(dst, color, n);
+		return;
+	}
+	for(; (unsigned long)dst & 15; --n)
+		*dst++ = color;
+	blocks = n / 8;
+	kernel_neon_begin();
+	asm volatile(
+		".fpu neon\n\t"
+		"vdup.32 q0, %[c]\n\t"
+		"vmov q1, q0\n"
+		"1:\n\t"
+		"vst1.32 {d0-d3}, [%[d]:128]!\n\t"
+		"subs %[b], %[b], #1\n\t"
+		"bne 1b\n\t"
+		: [d] "+r" (dst), [b] "+r" (blocks)
+		: [c] "r" (color)
+		: "d0", "d1", "d2", "d3", "cc", "memory");
+	kernel_neon_end();
+	scalar_fill32(dst, color, n & 7);
+}
+
+static void neon_copy32(u32* dst, const u32* src, unsigned int n)
+{
+	unsigned int blocks;
+	if(n < PK_SIMD_MIN_PIXELS)
+	{
+		scalar_copy32(dst, src, n);
+		return;
+	}
+	for(; (unsigned long)dst & 15; --n)
+		*dst++ = *src++;
+	blocks = n / 8;
+	kernel_neon_begin();
+	asm volatile(
+		".fpu neon\n"
+		"1:\n\t"
+		"vld1.32 {d0-d3}, [%[s]]!\n\t"
+		"vst1.32 {d0-d3}, [%[d]:128]!\n\t"
+		"subs %[b], %[b], #1\n\t"
+		"bne 1b\n\t"
+		: [d] "+r" (dst), [s] "+r" (src), [b] "+r" (blocks)
+		:
+		: "d0", "d1", "d2", "d3", "cc", "memory");
+	kernel_neon_end();
+	scalar_copy32(dst, src, n & 7);
+}
+
+static void neon_expand32(u32* dst, const u8* mask, unsigned int n, const u32 on, const u32 off)
+{
+	unsigned int blocks;
+	if(n < PK_SIMD_MIN_PIXELS)
+	{
+		scalar_expand32(dst, mask, n, on, off);
+		return;
+	}
+	blocks = n / 8;
+	kernel_neon_begin();
+	asm volatile(
+		".fpu neon\n\t"
+		"vdup.32 q0, %[on]\n\t"
+		"vdup.32 q1, %[off]\n"
+		"1:\n\t"
+		"vld1.8 {d4}, [%[m]]!\n\t"
+		"vmovl.u8 q3, d4\n\t"
+		"vmovl.u16 q8, d6\n\t"
+		"vmovl.u16 q9, d7\n\t"
+		"vtst.32 q8, q8, q8\n\t"
+		"vtst.32 q9, q9, q9\n\t"
+		"vbsl q8, q0, q1\n\t"
+		"vbsl q9, q0, q1\n\t"
+		"vst1.32 {d16-d19}, [%[d]]!\n\t"
+		"subs %[b], %[b], #1\n\t"
+		"bne 1b\n\t"
+		: [d] "+r" (dst), [m] "+r" (mask), [b] "+r" (blocks)
+		: [on] "r" (on), [off] "r" (off)
+		: "d0", "d1", "d2", "d3", "d4", "d6", "d7", "d16", "d17", "d18", "d19", "cc", "memory");
+	kernel_neon_end();
+	scalar_expand32(dst, mask, n & 7, on, off);
+}
+
+// t = s*a + d*(255-a) per byte in 16 bit lanes, then (t + ((t + 128) >> 8) + 128) >> 8
+// which is vrshr + vraddhn
+static void neon_blend32(u32* dst, const u32 color, unsigned int n, const u32 alpha)
+{
+	unsigned int blocks;
+	if(n < PK_SIMD_MIN_PIXELS)
+	{
+		scalar_blend32(dst, color, n, alpha);
+		return;
+	}
+	for(; (unsigned long)dst & 15; --n, ++dst)
+		*dst = blend_pixel32(color, *dst, alpha);
+	blocks = n / 4;
+	kernel_neon_begin();
+	asm volatile(
+		".fpu neon\n\t"
+		"vdup.32 d0, %[c]\n\t"
+		"vdup.8 d1, %[a]\n\t"
+		"vdup.8 d2, %[ia]\n\t"
+		"vmull.u8 q2, d0, d1\n"
+		"1:\n\t"
+		"vld1.32 {d16-d17}, [%[d]:128]\n\t"
+		"vmov q9, q2\n\t"
+		"vmov q10, q2\n\t"
+		"vmlal.u8 q9, d16, d2\n\t"
+		"vmlal.u8 q10, d17, d2\n\t"
+		"vrshr.u16 q11, q9, #8\n\t"
+		"vrshr.u16 q12, q10, #8\n\t"
+		"vraddhn.u16 d16, q9, q11\n\t"
+		"vraddhn.u16 d17, q10, q12\n\t"
+		"vst1.32 {d16-d17}, [%[d]:128]!\n\t"
+		"subs %[b], %[b], #1\n\t"
+		"bne 1b\n\t"
+		: [d] "+r" (dst), [b] "+r" (blocks)
+		: [c] "r" (color), [a] "r" (alpha), [ia] "r" (255 - alpha)
+		: "d0", "d1", "d2", "d4", "d5", "d16", "d17", "d18", "d19", "d20", "d21",
+		  "d22", "d23", "d24", "d25", "cc", "memory");
+	kernel_neon_end();
+	scalar_blend32(dst, color, n & 3, alpha);
+}
+
+static void neon_blendcopy32(u32* dst, const u32* src, unsigned int n, const u32 alpha)
+{
+	unsigned int blocks;
+	if(n < PK_SIMD_MIN_PIXELS)
+	{
+		scalar_blendcopy32(dst, src, n, alpha);
+		return;
+	}
+	for(; (unsigned long)dst & 15; --n, ++dst)
+		*dst = blend_pixel32(*src++, *dst, alpha);
+	blocks = n / 4;
+	kernel_neon_begin();
+	asm volatile(
+		".fpu neon\n\t"
+		"vdup.8 d0, %[a]\n\t"
+		"vdup.8 d1, %[ia]\n"
+		"1:\n\t"
+		"vld1.32 {d4-d5}, [%[s]]!\n\t"
+		"vld1.32 {d16-d17}, [%[d]:128]\n\t"
+		"vmull.u8 q9, d4, d0\n\t"
+		"vmull.u8 q10, d5, d0\n\t"
+		"vmlal.u8 q9, d16, d1\n\t"
+		"vmlal.u8 q10, d17, d1\n\t"
+		"vrshr.u16 q11, q9, #8\n\t"
+		"vrshr.u16 q12, q10, #8\n\t"
+		"vraddhn.u16 d16, q9, q11\n\t"
+		"vraddhn.u16 d17, q10, q12\n\t"
+		"vst1.32 {d16-d17}, [%[d]:128]!\n\t"
+		"subs %[b], %[b], #1\n\t"
+		"bne 1b\n\t"
+		: [d] "+r" (dst), [s] "+r" (src), [b] "+r" (blocks)
+		: [a] "r" (alpha), [ia] "r" (255 - alpha)
+		: "d0", "d1", "d4", "d5", "d16", "d17", "d18", "d19", "d20", "d21",
+		  "d22", "d23", "d24", "d25", "cc", "memory");
+	kernel_neon_end();
+	scalar_blendcopy32(dst, src, n & 3, alpha);
+}
+
+static const struct PixelKernels neon_kernels =
+{
+	"neon", neon_fill32, neon_copy32, neon_expand32,
+	neon_blend32, neon_blendcopy32, scalar_blendmask32
+};
+#endif //PK_HAVE_NEON
+
+#ifdef PK_HAVE_SSE2
+static void sse2_fill32(u32* dst, const u32 color, unsigned int n)
+{
+	unsigned int blocks;
+	if(n < PK_SIMD_MIN_PIXELS)
+	{
+		scalar_fill32(dst, color, n);
+		return;
+	}
+	blocks = n / 8;
+	kernel_fpu_begin();
+	asm volatile(
+		"movd %[c], %%xmm0\n\t"
+		"pshufd $0, %%xmm0, %%xmm0\n"
+		"1:\n\t"
+		"movdqu %%xmm0, (%[d])\n\t"
+		"movdqu %%xmm0, 16(%[d])\n\t"
+		"add $32, %[d]\n\t"
+		"dec %[b]\n\t"
+		"jnz 1b\n\t"
+		: [d] "+r" (dst), [b] "+r" (blocks)
+		: [c] "r" (color)
+		: "xmm0", "cc", "memory");
+	kernel_fpu_end();
+	scalar_fill32(dst, color, n & 7);
+}
+
+static void sse2_copy32(u32* dst, const u32* src, unsigned int n)
+{
+	unsigned int blocks;
+	if(n < PK_SIMD_MIN_PIXELS)
+	{
+		scalar_copy32(dst, src, n);
+		return;
+	}
+	blocks = n / 8;
+	kernel_fpu_begin();
+	asm volatile(
+		"1:\n\t"
+		"movdqu (%[s]), %%xmm0\n\t"
+		"movdqu 16(%[s]), %%xmm1\n\t"
+		"movdqu %%xmm0, (%[d])\n\t"
+		"movdqu %%xmm1, 16(%[d])\n\t"
+		"add $32, %[s]\n\t"
+		"add $32, %[d]\n\t"
+		"dec %[b]\n\t"
+		"jnz 1b\n\t"
+		: [d] "+r" (dst), [s] "+r" (src), [b] "+r" (blocks)
+		:
+		: "xmm0", "xmm1", "cc", "memory");
+	kernel_fpu_end();
+	scalar_copy32(dst, src, n & 7);
+}
+
+static void sse2_expand32(u32* dst, const u8* mask, unsigned int n, const u32 on, const u32 off)
+{
+	unsigned int blocks;
+	if(n < PK_SIMD_MIN_PIXELS)
+	{
+		scalar_expand32(dst, mask, n, on, off);
+		return;
+	}
+	blocks = n / 8;
+	kernel_fpu_begin();
+	asm volatile(
+		"movd %[on], %%xmm0\n\t"
+		"pshufd $0, %%xmm0, %%xmm0\n\t"
+		"movd %[off], %%xmm1\n\t"
+		"pshufd $0, %%xmm1, %%xmm1\n\t"
+		"pxor %%xmm7, %%xmm7\n"
+		"1:\n\t"
+		"movq (%[m]), %%xmm2\n\t"
+		"punpcklbw %%xmm7, %%xmm2\n\t"
+		"movdqa %%xmm2, %%xmm3\n\t"
+		"punpcklwd %%xmm7, %%xmm2\n\t"
+		"punpckhwd %%xmm7, %%xmm3\n\t"
+		// all ones where the mask byte is 0
+		"pcmpeqd %%xmm7, %%xmm2\n\t"
+		"pcmpeqd %%xmm7, %%xmm3\n\t"
+		"movdqa %%xmm2, %%xmm4\n\t"
+		"movdqa %%xmm3, %%xmm5\n\t"
+		"pand %%xmm1, %%xmm2\n\t"
+		"pand %%xmm1, %%xmm3\n\t"
+		"pandn %%xmm0, %%xmm4\n\t"
+		"pandn %%xmm0, %%xmm5\n\t"
+		"por %%xmm4, %%xmm2\n\t"
+		"por %%xmm5, %%xmm3\n\t"
+		"movdqu %%xmm2, (%[d])\n\t"
+		"movdqu %%xmm3, 16(%[d])\n\t"
+		"add $8, %[m]\n\t"
+		"add $32, %[d]\n\t"
+		"dec %[b]\n\t"
+		"jnz 1b\n\t"
+		: [d] "+r" (dst), [m] "+r" (mask), [b] "+r" (blocks)
+		: [on] "r" (on), [off] "r" (off)
+		: "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm7", "cc", "memory");
+	kernel_fpu_end();
+	scalar_expand32(dst, mask, n & 7, on, off);
+}
+
+// t = s*a + 128 + d*(255-a) per byte in 16 bit lanes, then (t + (t >> 8)) >> 8
+#define SSE2_ROUND255(t, tmp) \
+		"movdqa %%" t ", %%" tmp "\n\t" \
+		"psrlw $8, %%" tmp "\n\t" \
+		"paddw %%" tmp ", %%" t "\n\t" \
+		"psrlw $8, %%" t "\n\t"
+
+static void sse2_blend32(u32* dst, const u32 color, unsigned int n, const u32 alpha)
+{
+	unsigned int blocks;
+	if(n < PK_SIMD_MIN_PIXELS)
+	{
+		scalar_blend32(dst, color, n, alpha);
+		return;
+	}
+	blocks = n / 4;
+	kernel_fpu_begin();
+	asm volatile(
+		"pxor %%xmm7, %%xmm7\n\t"
+		"movd %[c], %%xmm0\n\t"
+		"pshufd $0, %%xmm0, %%xmm0\n\t"
+		"punpcklbw %%xmm7, %%xmm0\n\t"
+		"movd %[a], %%xmm1\n\t"
+		"pshuflw $0, %%xmm1, %%xmm1\n\t"
+		"pshufd $0, %%xmm1, %%xmm1\n\t"
+		"movd %[ia], %%xmm2\n\t"
+		"pshuflw $0, %%xmm2, %%xmm2\n\t"
+		"pshufd $0, %%xmm2, %%xmm2\n\t"
+		"movd %[r], %%xmm6\n\t"
+		"pshufd $0, %%xmm6, %%xmm6\n\t"
+		"pmullw %%xmm1, %%xmm0\n\t"
+		"paddw %%xmm6, %%xmm0\n"
+		"1:\n\t"
+		"movdqu (%[d]), %%xmm3\n\t"
+		"movdqa %%xmm3, %%xmm4\n\t"
+		"punpcklbw %%xmm7, %%xmm3\n\t"
+		"punpckhbw %%xmm7, %%xmm4\n\t"
+		"pmullw %%xmm2, %%xmm3\n\t"
+		"pmullw %%xmm2, %%xmm4\n\t"
+		"paddw %%xmm0, %%xmm3\n\t"
+		"paddw %%xmm0, %%xmm4\n\t"
+		SSE2_ROUND255("xmm3", "xmm5")
+		SSE2_ROUND255("xmm4", "xmm5")
+		"packuswb %%xmm4, %%xmm3\n\t"
+		"movdqu %%xmm3, (%[d])\n\t"
+		"add $16, %[d]\n\t"
+		"dec %[b]\n\t"
+		"jnz 1b\n\t"
+		: [d] "+r" (dst), [b] "+r" (blocks)
+		: [c] "r" (color), [a] "r" (alpha), [ia] "r" (255 - alpha), [r] "r" (0x00800080)
+		: "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7", "cc", "memory");
+	kernel_fpu_end();
+	scalar_blend32(dst, color, n & 3, alpha);
+}
+
+static void sse2_blendcopy32(u32* dst, const u32* src, unsigned int n, const u32 alpha)
+{
+	unsigned int blocks;
+	if(n < PK_SIMD_MIN_PIXELS)
+	{
+		scalar_blendcopy32(dst, src, n, alpha);
+		return;
+	}
+	blocks = n / 4;
+	kernel_fpu_begin();
+	asm volatile(
+		"pxor %%xmm7, %%xmm7\n\t"
+		"movd %[a], %%xmm1\n\t"
+		"pshuflw $0, %%xmm1, %%xmm1\n\t"
+		"pshufd $0, %%xmm1, %%xmm1\n\t"
+		"movd %[ia], %%xmm2\n\t"
+		"pshuflw $0, %%xmm2, %%xmm2\n\t"
+		"pshufd $0, %%xmm2, %%xmm2\n\t"
+		"movd %[r], %%xmm6\n\t"
+		"pshufd $0, %%xmm6, %%xmm6\n"
+		"1:\n\t"
+		"movdqu (%[s]), %%xmm0\n\t"
+		"movdqa %%xmm0, %%xmm5\n\t"
+		"punpcklbw %%xmm7, %%xmm0\n\t"
+		"punpckhbw %%xmm7, %%xmm5\n\t"
+		"pmullw %%xmm1, %%xmm0\n\t"
+		"pmullw %%xmm1, %%xmm5\n\t"
+		"movdqu (%[d]), %%xmm3\n\t"
+		"movdqa %%xmm3, %%xmm4\n\t"
+		"punpcklbw %%xmm7, %%xmm3\n\t"
+		"punpckhbw %%xmm7, %%xmm4\n\t"
+		"pmullw %%xmm2, %%xmm3\n\t"
+		"pmullw %%xmm2, %%xmm4\n\t"
+		"paddw %%xmm0, %%xmm3\n\t"
+		"paddw %%xmm5, %%xmm4\n\t"
+		"paddw %%xmm6, %%xmm3\n\t"
+		"paddw %%xmm6, %%xmm4\n\t"
+		SSE2_ROUND255("xmm3", "xmm5")
+		SSE2_ROUND255("xmm4", "xmm5")
+		"packuswb %%xmm4, %%xmm3\n\t"
+		"movdqu %%xmm3, (%[d])\n\t"
+		"add $16, %[s]\n\t"
+		"add $16, %[d]\n\t"
+		"dec %[b]\n\t"
+		"jnz 1b\n\t"
+		: [d] "+r" (dst), [s] "+r" (src), [b] "+r" (blocks)
+		: [a] "r" (alpha), [ia] "r" (255 - alpha), [r] "r" (0x00800080)
+		: "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7", "cc", "memory");
+	kernel_fpu_end();
+	scalar_blendcopy32(dst, src, n & 3, alpha);
+}
+
+static const struct PixelKernels sse2_kernels =
+{
+	"sse2", sse2_fill32, sse2_copy32, sse2_expand32,
+	sse2_blend32, sse2_blendcopy32, scalar_blendmask32
+};
+#endif //PK_HAVE_SSE2
+
+static const struct PixelKernels* pk = &scalar_kernels;
+
+static char* pixel_kernels = "auto";
+module_param(pixel_kernels, charp, 0444);
+MODULE_PARM_DESC(pixel_kernels, "pixel kernel variant: auto, scalar, neon or sse2");
+
+// runs every kernel of the variant on all lengths up to a few SIMD blocks and every
+// alignment and compares the result with the scalar reference
+static bool pixel_kernels_selftest(const struct PixelKernels* k)
+{
+	const unsigned int len = 4*PK_SIMD_MIN_PIXELS + 8;
+	u32 *ref, *out, *src;
+	u8* mask;
+	unsigned int n, off, i;
+	bool ok = true;
+
+	ref = kmalloc_array(3*len, sizeof(u32), GFP_KERNEL);
+	mask = kmalloc(len, GFP_KERNEL);
+	if(!ref || !mask)
+	{
+		kfree(ref);
+		kfree(mask);
+		return false;
+	}
+	out = ref + len;
+	src = out + len;
+	for(i=0; i<len; ++i)
+	{
+		src[i] = 0x01020304u * (i+1);
+		mask[i] = (i*7 % 3 == 0) ? 0 : (u8)i;
+	}
+
+	for(n=0; ok && n<len-4; ++n)
+		for(off=0; ok && off<4; ++off)
+		{
+			memset(ref, 0x5a, 2*len*sizeof(u32));
+			scalar_fill32(ref+off, 0xa5c3e1f0, n);
+			k->fill32(out+off, 0xa5c3e1f0, n);
+			ok = !memcmp(ref, out, len*sizeof(u32));
+
+			scalar_copy32(ref+off, src+(n & 3), n);
+			k->copy32(out+off, src+(n & 3), n);
+			ok = ok && !memcmp(ref, out, len*sizeof(u32));
+
+			scalar_expand32(ref+off, mask+(n & 3), n, 0x00ff00ff, 0xff00ff00);
+			k->expand32(out+off, mask+(n & 3), n, 0x00ff00ff, 0xff00ff00);
+			ok = ok && !memcmp(ref, out, len*sizeof(u32));
+
+			// destinations hold the expanded pattern now, blending runs over varying pixels
+			scalar_blend32(ref+off, 0x80ff7f01, n, (n*37 + off) % 256);
+			k->blend32(out+off, 0x80ff7f01, n, (n*37 + off) % 256);
+			ok = ok && !memcmp(ref, out, len*sizeof(u32));
+
+			scalar_blendcopy32(ref+off, src+(n & 3), n, (n*91 + off) % 256);
+			k->blendcopy32(out+off, src+(n & 3), n, (n*91 + off) % 256);
+			ok = ok && !memcmp(ref, out, len*sizeof(u32));
+		}
+
+	kfree(ref);
+	kfree(mask);
+	return ok;
+}
+
+// full frame fill and copy throughput, printed at load time so variants can be compared on the target
+static void pixel_kernels_bench(const struct PixelKernels* k)
+{
+	const unsigned int n = 640*480, loops = 8;
+	u32* buff = vmalloc(2*n*sizeof(u32));
+	u64 fill_ns, copy_ns, blend_ns;
+	unsigned int i;
+	ktime_t start;
+
+	if(!buff)
+		return;
+	start = ktime_get();
+	for(i=0; i<loops; ++i)
+		k->fill32(buff, i, n);
+	fill_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+	start = ktime_get();
+	for(i=0; i<loops; ++i)
+		k->copy32(buff + n, buff, n);
+	copy_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+	start = ktime_get();
+	for(i=0; i<loops; ++i)
+		k->blend32(buff, 0x00808080, n, 96);
+	blend_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+	vfree(buff);
+
+	printk(KERN_INFO "vga_dma: %s kernels: fill %llu MB/s, copy %llu MB/s, blend %llu MB/s\n", k->name,
+		fill_ns ? div64_u64((u64)loops*n*4*1000, fill_ns) : 0, copy_ns ? div64_u64((u64)loops*n*4*1000, copy_ns) : 0,
+		blend_ns ? div64_u64((u64)loops*n*4*1000, blend_ns) : 0);
+}
+
+static void pixel_kernels_init(void)
+{
+	const struct PixelKernels* candidate = NULL;
+	bool force = strcmp(pixel_kernels, "auto") != 0;
+
+#ifdef PK_HAVE_NEON
+	if((!force || !strcmp(pixel_kernels, "neon")) && (elf_hwcap & HWCAP_NEON))
+		candidate = &neon_kernels;
+#endif
+#ifdef PK_HAVE_SSE2
+	if((!force || !strcmp(pixel_kernels, "sse2")) && boot_cpu_has(X86_FEATURE_XMM2))
+		candidate = &sse2_kernels;
+#endif
+	if(force && !candidate && strcmp(pixel_kernels, "scalar"))
+		printk(KERN_WARNING "vga_dma: %s kernels aren't available, using scalar\n", pixel_kernels);
+
+	pk = &scalar_kernels;
+	pixel_kernels_bench(pk);
+	if(!candidate)
+		return;
+	if(!pixel_kernels_selftest(candidate))
+	{
+		printk(KERN_ERR "vga_dma: %s kernels differ from scalar reference, using scalar\n", candidate->name);
+		return;
+	}
+	pixel_kernels_bench(candidate);
+	pk = candidate;
+	printk(KERN_INFO "vga_dma: using %s pixel kernels\n", pk->name);
+}
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_PIXELKERNELS_H_
@@ -0,0 +1,24 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_POLYGON_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_POLYGON_H_
+
+#include "utils.h"
+#include "Point.h"
+
+struct Polygon
+{
+	struct Point pt[POLY_MAX_POINTS];
+	unsigned int n;
+	unsigned long long poly_color;
+	u8 poly_alpha;
+};
+
+// one non horizontal polygon edge, x is the first pixel whose center lies right of the edge
+// at the center of the current scanline, stepped exactly with an integer error term
+struct Edge
+{
+	int ymin, ymax;
+	int x, err, den;
+	int xstep, errstep;
+};
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_POLYGON_H_
@@ -1,15 +1,14 @@
 #include "Circle.h"
 
-void setCircle(struct Circle* circle, const char(* commands)[BUFF_SIZE])
+// circ;xc;yc;r;COLOR[@ALPHA];FILL|NO
+int setCircle(struct Circle* circle, const char* const* commands)
 {
-	int ret;
-	circle->pt.x = strToInt(commands[1]);
-	circle->pt.y = strToInt(commands[2]);
-	circle->r = strToInt(commands[3]);
-	ret = kstrtoull((unsigned char*)commands[4],0, &circle->circle_color);
-	if(ret)
-		return;
+	if(strToInt(commands[1], &circle->pt.x) || strToInt(commands[2], &circle->pt.y) || strToInt(commands[3], &circle->r))
+		return -1;
+	if(parse_color(commands[4], &circle->circle_color, &circle->circle_alpha))
+		return -1;
 	circle->fill_circle = (!strcmp(commands[5],"fill") || !strcmp(commands[5],"FILL")) ? true : false;
+	return 0;
 }
 
 struct _8points SetOfCirclePoints(int xc, int yc, int x, int y)
@@ -42,27 +41,42 @@ struct _8points SetOfCirclePoints(int xc, int yc, int x, int y)
 	return pts;
 }
 
-void fill8points(const struct _8points* pts, const bool fill, const unsigned long long color)
+// half widths of the filled circle per screen row, -1 for rows it doesn't cover
+static int circle_rows[MAX_H+1];
+
+// outline pixels are drawn once even where octants meet, filled circles only collect
+// the widest span of every row and are drawn row by row in CircleOnScreen
+void fill8points(const struct _8points* pts, const struct Circle* circle)
 {
-	int j,k;
+	int i, j;
 	if(pts == NULL)
 		return;
-	for(j=0; j<4; ++j)
+	for(i=0; i<8; ++i)
 	{
-		tx_vir_buffer[640*pts->pt[2*j].y + pts->pt[2*j].x] = (u32)color;
-		tx_vir_buffer[640*pts->pt[2*j].y + pts->pt[2*j+1].x] = (u32)color;
-		if(fill)	
-			for(k=pts->pt[2*j+1].x+1;k<pts->pt[2*j].x;++k)
-				tx_vir_buffer[640*pts->pt[2*j].y + k] = (u32)color;			
+		if(circle->fill_circle)
+		{
+			// pt[i^1] mirrors pt[i] over the center column
+			const int y = pts->pt[i].y, half = (int)pts->pt[i].x - (int)circle->pt.x;
+			if(y >= 0 && y <= MAX_H && half > circle_rows[y])
+				circle_rows[y] = half;
+			continue;
+		}
+		for(j=0; j<i && (pts->pt[j].x != pts->pt[i].x || pts->pt[j].y != pts->pt[i].y); ++j);
+		if(j == i)
+			put_pixel_alpha(pts->pt[i].x, pts->pt[i].y, (u32)circle->circle_color, circle->circle_alpha);
 	}
 }
 
 void CircleOnScreen(const struct Circle* circle)
 {
-	int x = 0, y = circle->r;
+	int x = 0, y = circle->r, row;
 	int d = 3 - 2 * circle->r;
-	struct _8points tmp = SetOfCirclePoints(circle->pt.x,circle->pt.y,x,y);
-	fill8points(&tmp,circle->fill_circle, circle->circle_color);
+	struct _8points tmp;
+	if(circle->fill_circle)
+		for(row=0; row<=MAX_H; ++row)
+			circle_rows[row] = -1;
+	tmp = SetOfCirclePoints(circle->pt.x,circle->pt.y,x,y);
+	fill8points(&tmp, circle);
 	while(y >= x)
 	{
 		++x;
@@ -73,7 +87,16 @@ void CircleOnScreen(const struct Circle* circle)
 		}
 		else
 			d = d + 4*x +6;
+		// the last step crosses the diagonal and only repeats points of the other octants
+		if(x > y)
+			break;
 		tmp = SetOfCirclePoints(circle->pt.x,circle->pt.y,x,y);
-		fill8points(&tmp,circle->fill_circle, circle->circle_color);
+		fill8points(&tmp, circle);
 	}
+	if(!circle->fill_circle)
+		return;
+	for(row=0; row<=MAX_H; ++row)
+		if(circle_rows[row] >= 0)
+			fill_span_alpha(row, (int)circle->pt.x - circle_rows[row], (int)circle->pt.x + circle_rows[row],
+				(u32)circle->circle_color, circle->circle_alpha);
 }
@@ -0,0 +1,269 @@
+#include "Commit.h"
+
+static LIST_HEAD(gc_files);		// open files, each one queues its own batch
+static LIST_HEAD(commit_ready);		// committed batches, applied after the next frame interrupt
+static bool commit_pending = false;	// commit_ready has something, read by dma_isr
+static bool commit_vsync = false;	// frame interrupts are running, otherwise commits are applied at once
+static unsigned long commit_applied = 0, commit_coalesced = 0;
+
+static void commit_free(struct list_head* ops)
+{
+	struct CommitOp *op, *tmp;
+	list_for_each_entry_safe(op, tmp, ops, list)
+	{
+		list_del(&op->list);
+		kfree(op->line);
+		kfree(op);
+	}
+}
+
+static void commit_clear(void)
+{
+	commit_free(&commit_ready);
+	WRITE_ONCE(commit_pending, false);
+}
+
+// drops shapes which an opaque filled rect later in the batch paints over completely,
+// text commands in between (obj, spr, pan, font) may read the screen, move it or change
+// how text is drawn so they end the search
+static void commit_coalesce(struct list_head* ops)
+{
+	struct CommitOp *op, *prev, *tmp;
+	list_for_each_entry(op, ops, list)
+	{
+		struct Box cover;
+		if(op->line || op->shape.type != state_RECT || !op->shape.rect.fill_rect || op->shape.rect.rect_alpha != 255)
+			continue;
+		cover = box_on_screen(op->shape.box);
+		cover = box_intersect(&cover, &op->clip);
+		prev = list_entry(op->list.prev, struct CommitOp, list);
+		while(&prev->list != ops && !prev->line)
+		{
+			struct Box box = box_on_screen(prev->shape.box);
+			box = box_intersect(&box, &prev->clip);
+			tmp = list_entry(prev->list.prev, struct CommitOp, list);
+			if(box_empty(&box) || box_inside(&box, &cover))
+			{
+				list_del(&prev->list);
+				kfree(prev);
+				commit_coalesced++;
+			}
+			prev = tmp;
+		}
+	}
+}
+
+// shapes with the same clip box between two text commands are drawn together,
+// tile by tile when there are enough of them
+static void commit_draw(const struct Shape** shapes, const unsigned int n, const struct Box* area)
+{
+	const struct Box screen = {0, 0, MAX_W, MAX_H};
+	struct Box box = {MAX_W+1, MAX_H+1, -1, -1};
+	struct Sprite* lifted = NULL;
+	unsigned int i;
+	if(!n)
+		return;
+	// sprites over the batch are lifted, they save what it drew under them
+	if(!list_empty(&sprites))
+	{
+		for(i=0; i<n; ++i)
+			box = box_union(&box, &shapes[i]->box);
+		box = box_intersect(&box, area);
+		lifted = box_empty(&box) ? NULL : sprites_over(&box, 1);
+	}
+	if(lifted)
+		sprites_lift(lifted);
+	if(tile_render(shapes, n, area, NULL))
+	{
+		clip = *area;
+		for(i=0; i<n; ++i)
+			ShapeOnScreen(shapes[i]);
+		clip = screen;
+	}
+	if(lifted)
+		sprites_drop(&lifted->list);
+}
+
+// draws the committed batches, called with the driver lock held
+static void commit_apply(void)
+{
+	struct CommitOp* op;
+	const char* commands[CMD_FIELDS+1];
+	const struct Shape** shapes;
+	struct Box area = {0, 0, MAX_W, MAX_H};
+	unsigned int n = 0, nshapes = 0;
+	unsigned long coalesced;
+	u64 start;
+
+	WRITE_ONCE(commit_pending, false);
+	defio_flush();
+	if(list_empty(&commit_ready))
+		return;
+	start = ktime_get_ns();
+	// the trace gets the commands coalesced away in this commit, the total goes on
+	coalesced = commit_coalesced;
+	commit_coalesce(&commit_ready);
+	list_for_each_entry(op, &commit_ready, list)
+		++n;
+	shapes = kmalloc_array(n, sizeof(*shapes), GFP_KERNEL);
+	n = 0;
+	list_for_each_entry(op, &commit_ready, list)
+	{
+		++n;
+		if(!op->line)
+		{
+			if(!shapes)
+			{
+				const struct Shape* one = &op->shape;
+				commit_draw(&one, 1, &op->clip);
+				continue;
+			}
+			if(nshapes && memcmp(&area, &op->clip, sizeof(area)))
+			{
+				commit_draw(shapes, nshapes, &area);
+				nshapes = 0;
+			}
+			area = op->clip;
+			shapes[nshapes++] = &op->shape;
+			continue;
+		}
+		commit_draw(shapes, nshapes, &area);
+		nshapes = 0;
+		parse_buffer(op->line, commands);
+		assign_params_from_commands(getState(commands[0]), commands);
+	}
+	commit_draw(shapes, nshapes, &area);
+	kfree(shapes);
+	commit_free(&commit_ready);
+	scene_flush();
+	commit_applied += n;
+	trace_vga_commit(n, commit_coalesced - coalesced, ktime_get_ns() - start);
+	pr_debug("VGA_DMA: committed %u commands (%lu applied, %lu coalesced so far)\n", n, commit_applied, commit_coalesced);
+}
+
+// hands the written batch over to the next frame
+static void commit_now(struct GContext* gc)
+{
+	list_splice_tail_init(&gc->commit_queue, &commit_ready);
+	gc->commit_queued = 0;
+	if(!commit_vsync)
+	{
+		commit_apply();
+		return;
+	}
+	WRITE_ONCE(commit_pending, true);
+}
+
+// the fields joined back into a command line, with the graphics context already applied
+static char* commit_line(const char* const* commands)
+{
+	size_t len = 0;
+	int i, n = 0;
+	char* line;
+	for(i=0; i<CMD_FIELDS; ++i)
+		if(commands[i][0])
+			n = i+1;
+	for(i=0; i<n; ++i)
+		len += strlen(commands[i]) + 1;
+	line = kmalloc(len + 1, GFP_KERNEL);
+	if(!line)
+		return NULL;
+	for(i=0, len=0; i<n; ++i)
+	{
+		strcpy(line + len, commands[i]);
+		len += strlen(commands[i]);
+		line[len++] = ';';
+	}
+	line[len ? len-1 : 0] = '\0';
+	return line;
+}
+
+static int commit_add(struct GContext* gc, const state_t state, const char* const* commands)
+{
+	struct CommitOp* op = kmalloc(sizeof(*op), GFP_KERNEL);
+	if(!op)
+		return -1;
+	op->line = NULL;
+	op->clip = gc->clip;
+	if(state == state_OBJ || state == state_SPR || state == state_PAN || state == state_FONT)
+	{
+		op->line = commit_line(commands);
+		if(!op->line)
+		{
+			kfree(op);
+			return -1;
+		}
+	}
+	else if(setShape(&op->shape, commands))
+	{
+		kfree(op);
+		return -1;
+	}
+	list_add_tail(&op->list, &gc->commit_queue);
+	if(++gc->commit_queued == COMMIT_QUEUE_MAX)
+	{
+		printk(KERN_WARNING "VGA_DMA: commit queue is full, applying it now\n");
+		list_splice_tail_init(&gc->commit_queue, &commit_ready);
+		gc->commit_queued = 0;
+		commit_apply();
+	}
+	return 0;
+}
+
+// called at the end of every write, in auto mode each write is shown as a whole in one frame
+static void commit_write_done(struct GContext* gc)
+{
+	if(gc->commit_mode == commit_AUTO && gc->commit_queued)
+		commit_now(gc);
+}
+
+static void commit_open(struct GContext* gc)
+{
+	gc->commit_mode = commit_OFF;
+	INIT_LIST_HEAD(&gc->commit_queue);
+	gc->commit_queued = 0;
+	list_add_tail(&gc->list, &gc_files);
+}
+
+// whatever is still queued at close is dropped
+static void commit_close(struct GContext* gc)
+{
+	list_del(&gc->list);
+	commit_free(&gc->commit_queue);
+	gc->commit_queued = 0;
+}
+
+// The mode belongs to the open file, other files keep drawing in their own mode.
+// commit              - shows everything queued since the last commit (and the shadow mapping) after the next frame
+// commit;manual       - commands are queued until commit
+// commit;auto         - commands of every write are queued and shown together after the next frame
+// commit;off          - commands are drawn right away (default), the queue is applied first
+static int commit_command(struct GContext* gc, const char* const* commands)
+{
+	if(commands[1][0] == '\0')
+	{
+		// with nothing to queue commit only shows what was drawn to the shadow mapping
+		if(gc->commit_mode == commit_OFF)
+			defio_flush();
+		else
+			commit_now(gc);
+		return 0;
+	}
+	if(!strcmp(commands[1],"manual") || !strcmp(commands[1],"MANUAL"))
+		gc->commit_mode = commit_MANUAL;
+	else if(!strcmp(commands[1],"auto") || !strcmp(commands[1],"AUTO"))
+		gc->commit_mode = commit_AUTO;
+	else if(!strcmp(commands[1],"off") || !strcmp(commands[1],"OFF"))
+	{
+		gc->commit_mode = commit_OFF;
+		list_splice_tail_init(&gc->commit_queue, &commit_ready);
+		gc->commit_queued = 0;
+		commit_apply();
+	}
+	else
+	{
+		printk(KERN_ERR "VGA_DMA: %s is not appropriate commit mode\n", commands[1]);
+		return -1;
+	}
+	return 0;
+}
@@ -0,0 +1,188 @@
+#include "GContext.h"
+
+static void gc_init(struct GContext* gc)
+{
+	strlcpy(gc->pen, "0xffffff", BUFF_SIZE);
+	strlcpy(gc->fill, "0x0", BUFF_SIZE);
+	gc->big_font = false;
+	gc->anti_alias = false;
+	gc->ox = 0, gc->oy = 0;
+	gc->clip.x0 = 0, gc->clip.y0 = 0, gc->clip.x1 = MAX_W, gc->clip.y1 = MAX_H;
+	gc->image.active = false;
+}
+
+static inline int field_count(const char* const* commands, const int max)
+{
+	int n;
+	for(n=0; n<max && commands[n][0]; ++n);
+	return n;
+}
+
+// puts value in as field at, the fields from at on move one place up
+static int field_insert(const char** commands, int* n, const int max, const int at, const char* value)
+{
+	if(*n >= max)
+		return -1;
+	memmove(commands + at + 1, commands + at, (*n - at)*sizeof(*commands));
+	commands[at] = value;
+	++*n;
+	return 0;
+}
+
+// moves every other coordinate field from first to last by d, the moved numbers are written to coords
+static int field_shift(const char** commands, char(* coords)[GC_COORD_SIZE], const int first, const int last, const int d)
+{
+	int i, v;
+	if(d == 0)
+		return 0;
+	for(i=first; i<=last; i+=2)
+	{
+		if(kstrtoint(commands[i], 10, &v) || v + d < 0)
+		{
+			printk(KERN_ERR "VGA_DMA: %s is not appropriate coordinate with origin %d\n", commands[i], d);
+			return -1;
+		}
+		snprintf(coords[i], sizeof(coords[i]), "%d", v + d);
+		commands[i] = coords[i];
+	}
+	return 0;
+}
+
+static inline int fill_word(const char* field)
+{
+	if(!strcmp(field,"fill") || !strcmp(field,"FILL"))
+		return 1;
+	if(!strcmp(field,"no") || !strcmp(field,"NO"))
+		return 0;
+	return -1;
+}
+
+// fills in what a drawing command leaves out and moves it to the origin, the short forms are
+// text;STRING;X;Y  line;X1;Y1;X2;Y2  rect;X1;Y1;X2;Y2[;FILL|NO]  circ;X;Y;R[;FILL|NO]  pix;X;Y
+// poly;X0;Y0;...  tri;X0;Y0;X1;Y1;X2;Y2 - outlines use the pen, filled shapes the fill color
+static int gc_expand(const struct GContext* gc, const state_t state, const char** commands, char(* coords)[GC_COORD_SIZE], const int max)
+{
+	int n = field_count(commands, max), ret = 0, fill;
+	switch(state)
+	{
+		case state_TEXT:
+			if(n == 4)
+			{
+				ret |= field_insert(commands, &n, max, 2, gc->big_font ? "big" : "small");
+				ret |= field_insert(commands, &n, max, 5, gc->pen);
+				ret |= field_insert(commands, &n, max, 6, gc->fill);
+				if(gc->anti_alias)
+					ret |= field_insert(commands, &n, max, 7, "aa");
+			}
+			return ret | field_shift(commands, coords, 3, 3, gc->ox) | field_shift(commands, coords, 4, 4, gc->oy);
+		case state_LINE:
+			if(n == 5)
+				ret = field_insert(commands, &n, max, 5, gc->pen);
+			return ret | field_shift(commands, coords, 1, 3, gc->ox) | field_shift(commands, coords, 2, 4, gc->oy);
+		case state_RECT:
+			if(n == 5)
+				ret = field_insert(commands, &n, max, 5, gc->pen) | field_insert(commands, &n, max, 6, "no");
+			else if(n == 6 && (fill = fill_word(commands[5])) >= 0)
+				ret = field_insert(commands, &n, max, 5, fill ? gc->fill : gc->pen);
+			return ret | field_shift(commands, coords, 1, 3, gc->ox) | field_shift(commands, coords, 2, 4, gc->oy);
+		case state_CIRC:
+			if(n == 4)
+				ret = field_insert(commands, &n, max, 4, gc->pen) | field_insert(commands, &n, max, 5, "no");
+			else if(n == 5 && (fill = fill_word(commands[4])) >= 0)
+				ret = field_insert(commands, &n, max, 4, fill ? gc->fill : gc->pen);
+			return ret | field_shift(commands, coords, 1, 1, gc->ox) | field_shift(commands, coords, 2, 2, gc->oy);
+		case state_PIX:
+			if(n == 3)
+				ret = field_insert(commands, &n, max, 3, gc->pen);
+			return ret | field_shift(commands, coords, 1, 1, gc->ox) | field_shift(commands, coords, 2, 2, gc->oy);
+		case state_POLY:
+		case state_TRI:
+			// points only, the field count is odd
+			if(n & 1)
+				ret = field_insert(commands, &n, max, n, gc->fill);
+			return ret | field_shift(commands, coords, 1, n-3, gc->ox) | field_shift(commands, coords, 2, n-2, gc->oy);
+		case state_OBJ:
+		case state_SPR:
+			// the command kept as object or sprite, and the sprite position
+			if(!strcmp(commands[1],"new") || !strcmp(commands[1],"set"))
+				return commands[3][0] ? gc_expand(gc, getState(commands[3]), commands + 3, coords + 3, max - 3) : 0;
+			if(state == state_SPR && !strcmp(commands[1],"at"))
+				return field_shift(commands, coords, 3, 3, gc->ox) | field_shift(commands, coords, 4, 4, gc->oy);
+		break;
+	}
+	return 0;
+}
+
+// gc;pen;COLOR          - color of lines, outlines, pixels and text
+// gc;fill;COLOR|none    - color of filled rects, circles and polygons and of the text background
+// gc;font;big|small[;aa]
+// gc;origin;X;Y         - added to the coordinates of the commands that follow (negative - left/up)
+// gc;clip;X0;Y0;X1;Y1   - ordinary drawing commands of this file only draw inside the rect, given
+//                         relative to the origin, gc;clip alone - whole screen
+// gc;reset              - back to the defaults
+static int gc_command(struct GContext* gc, const char* const* commands)
+{
+	unsigned long long color;
+	u8 alpha;
+
+	if(!strcmp(commands[1],"pen") || !strcmp(commands[1],"fill"))
+	{
+		char* field = !strcmp(commands[1],"pen") ? gc->pen : gc->fill;
+		if(field == gc->fill && (!strcmp(commands[2],"none") || !strcmp(commands[2],"NONE")))
+		{
+			strlcpy(field, "0x0@0", BUFF_SIZE);
+			return 0;
+		}
+		if(parse_color(commands[2], &color, &alpha))
+			return -1;
+		strlcpy(field, commands[2], BUFF_SIZE);
+	}
+	else if(!strcmp(commands[1],"font"))
+	{
+		if(!strcmp(commands[2],"big") || !strcmp(commands[2],"BIG"))
+			gc->big_font = true;
+		else if(!strcmp(commands[2],"small") || !strcmp(commands[2],"SMALL"))
+			gc->big_font = false;
+		else
+		{
+			printk(KERN_ERR "VGA_DMA: %s is not appropriate font\n", commands[2]);
+			return -1;
+		}
+		gc->anti_alias = !strcmp(commands[3],"aa") || !strcmp(commands[3],"AA");
+	}
+	else if(!strcmp(commands[1],"origin"))
+	{
+		int x, y;
+		if(kstrtoint(commands[2], 0, &x) || kstrtoint(commands[3], 0, &y))
+		{
+			printk(KERN_ERR "VGA_DMA: %s;%s is not appropriate origin\n", commands[2], commands[3]);
+			return -1;
+		}
+		gc->ox = x, gc->oy = y;
+	}
+	else if(!strcmp(commands[1],"clip"))
+	{
+		struct Box box = {0, 0, MAX_W, MAX_H};
+		if(commands[2][0])
+		{
+			if(kstrtoint(commands[2], 0, &box.x0) || kstrtoint(commands[3], 0, &box.y0) ||
+				kstrtoint(commands[4], 0, &box.x1) || kstrtoint(commands[5], 0, &box.y1))
+			{
+				printk(KERN_ERR "VGA_DMA: %s;%s;%s;%s is not appropriate clip rect\n", commands[2], commands[3], commands[4], commands[5]);
+				return -1;
+			}
+			box.x0 += gc->ox, box.x1 += gc->ox;
+			box.y0 += gc->oy, box.y1 += gc->oy;
+		}
+		// an empty clip rect is allowed, the file then draws nothing
+		gc->clip = box_on_screen(box);
+	}
+	else if(!strcmp(commands[1],"reset"))
+		gc_init(gc);
+	else
+	{
+		printk(KERN_ERR "VGA_DMA: %s is not appropriate context command\n", commands[1]);
+		return -1;
+	}
+	return 0;
+}
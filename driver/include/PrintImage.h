@@ -0,0 +1,179 @@
+#include "Image.h"
+
+// writes the collected run of equal pixels, it may go over several rows of the image
+static void image_flush_run(struct Image* img)
+{
+	while(img->run_len)
+	{
+		const int row = img->pos / img->w, col = img->pos % img->w;
+		const unsigned int n = min(img->run_len, (unsigned int)(img->w - col));
+		const int y = img->y + row;
+		const int x0 = max(img->x + col, img->area.x0), x1 = min(img->x + col + (int)n - 1, img->area.x1);
+		if(y >= img->area.y0 && y <= img->area.y1 && x0 <= x1)
+			pk->fill32(tx_vir_buffer + 640*y + x0, img->run_color, x1 - x0 + 1);
+		img->pos += n;
+		img->run_len -= n;
+	}
+}
+
+static inline void image_pixels(struct Image* img, const u32 color, unsigned int n)
+{
+	if(img->pos + img->run_len + n > img->pixels)
+		n = img->pixels - img->pos - img->run_len;
+	if(img->run_len && color != img->run_color)
+		image_flush_run(img);
+	img->run_color = color;
+	img->run_len += n;
+}
+
+static void image_byte(struct Image* img, const u8 b)
+{
+	switch(img->format)
+	{
+		case image_PAL8:
+			image_pixels(img, img->palette[b], 1);
+		break;
+		case image_PAL4:
+			image_pixels(img, img->palette[b >> 4], 1);
+			image_pixels(img, img->palette[b & 0xf], 1);
+		break;
+		case image_RLE:
+			// count-1, R, G, B
+			img->rec[img->nrec++] = b;
+			if(img->nrec == 4)
+			{
+				image_pixels(img, ((u32)img->rec[1] << 16) | ((u32)img->rec[2] << 8) | img->rec[3], img->rec[0] + 1);
+				img->nrec = 0;
+			}
+		break;
+		case image_RLE8:
+			// count-1, palette index
+			img->rec[img->nrec++] = b;
+			if(img->nrec == 2)
+			{
+				image_pixels(img, img->palette[img->rec[1]], img->rec[0] + 1);
+				img->nrec = 0;
+			}
+		break;
+	}
+}
+
+// img;data;HEX - image bytes, as many data commands as needed, pixels go left to right and top to bottom
+static int image_data(struct Image* img, const char* hex)
+{
+	struct Sprite* lifted;
+	int d, ret = 0;
+	if(!img->active)
+	{
+		printk(KERN_ERR "VGA_DMA: image data without img command\n");
+		return -1;
+	}
+	// every data command draws its own pixels, the sprites over the image are lifted meanwhile
+	lifted = box_empty(&img->area) ? NULL : sprites_over(&img->area, 1);
+	if(lifted)
+		sprites_lift(lifted);
+	for(; *hex && *hex != '\n'; ++hex)
+	{
+		if((d = hex_to_bin(*hex)) < 0)
+		{
+			printk(KERN_ERR "VGA_DMA: %c is not appropriate image data\n", *hex);
+			ret = -1;
+			break;
+		}
+		if(img->nibble < 0)
+		{
+			img->nibble = d;
+			continue;
+		}
+		image_byte(img, (u8)(img->nibble << 4 | d));
+		img->nibble = -1;
+		if(img->pos + img->run_len == img->pixels)
+		{
+			if(hex[1] && hex[1] != '\n')
+				printk(KERN_WARNING "VGA_DMA: image data past the last pixel is ignored\n");
+			break;
+		}
+	}
+	image_flush_run(img);
+	if(lifted)
+		sprites_drop(&lifted->list);
+	return ret;
+}
+
+// img;pal;HEX - palette entries RRGGBB, appended to the ones given since the img command
+static int image_palette(struct Image* img, const char* hex)
+{
+	u8 rgb[3];
+	if(!img->active)
+	{
+		printk(KERN_ERR "VGA_DMA: image palette without img command\n");
+		return -1;
+	}
+	for(; hex[0] && hex[0] != '\n'; hex += 6)
+	{
+		if(img->colors == IMAGE_PALETTE_SIZE || strnlen(hex, 6) < 6 || hex2bin(rgb, hex, 3))
+		{
+			printk(KERN_ERR "VGA_DMA: %.6s is not appropriate palette entry %u\n", hex, img->colors);
+			return -1;
+		}
+		img->palette[img->colors++] = ((u32)rgb[0] << 16) | ((u32)rgb[1] << 8) | rgb[2];
+	}
+	return 0;
+}
+
+static void image_end(struct Image* img)
+{
+	if(!img->active)
+		return;
+	image_flush_run(img);
+	if(img->pos < img->pixels)
+		printk(KERN_WARNING "VGA_DMA: image ended after %u of %u pixels\n", img->pos, img->pixels);
+	img->active = false;
+}
+
+// img;X;Y;W;H;FORMAT - starts an image, FORMAT is rle (runs of count-1, R, G, B), rle8 (runs of count-1,
+//                      palette index), pal8 (one palette index per byte) or pal4 (two per byte, high half first)
+// img;end            - the image is complete
+static int image_command(struct GContext* gc, const char* const* commands)
+{
+	struct Image* img = &gc->image;
+	struct Box box;
+	unsigned int x, y, w, h;
+
+	if(!strcmp(commands[1],"end") || !strcmp(commands[1],"END"))
+	{
+		image_end(img);
+		return 0;
+	}
+	image_end(img);
+	if(kstrtouint(commands[1], 10, &x) || kstrtouint(commands[2], 10, &y) ||
+		kstrtouint(commands[3], 10, &w) || kstrtouint(commands[4], 10, &h) ||
+		w == 0 || h == 0 || w > 4096 || h > 4096)
+	{
+		printk(KERN_ERR "VGA_DMA: %s;%s;%s;%s is not appropriate image rect\n", commands[1], commands[2], commands[3], commands[4]);
+		return -1;
+	}
+	if(!strcmp(commands[5],"rle") || !strcmp(commands[5],"RLE"))
+		img->format = image_RLE;
+	else if(!strcmp(commands[5],"rle8") || !strcmp(commands[5],"RLE8"))
+		img->format = image_RLE8;
+	else if(!strcmp(commands[5],"pal8") || !strcmp(commands[5],"PAL8"))
+		img->format = image_PAL8;
+	else if(!strcmp(commands[5],"pal4") || !strcmp(commands[5],"PAL4"))
+		img->format = image_PAL4;
+	else
+	{
+		printk(KERN_ERR "VGA_DMA: %s is not appropriate image format\n", commands[5]);
+		return -1;
+	}
+	img->x = x + gc->ox, img->y = y + gc->oy, img->w = w;
+	box.x0 = img->x, box.y0 = img->y, box.x1 = img->x + w - 1, box.y1 = img->y + h - 1;
+	img->area = box_intersect(&box, &gc->clip);
+	img->pos = 0, img->pixels = w*h;
+	memset(img->palette, 0, sizeof(img->palette));
+	img->colors = 0;
+	img->nrec = 0, img->nibble = -1;
+	img->run_len = 0;
+	img->active = true;
+	return 0;
+}
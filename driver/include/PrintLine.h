@@ -1,46 +1,38 @@
 #include "Line.h"
 
-int setLine(struct Line* line, const char(* commands)[BUFF_SIZE] )
+// line;x1;y1;x2;y2;COLOR[@ALPHA]
+int setLine(struct Line* line, const char* const* commands)
 {
-	int ret;
-	line->pt1.x = strToInt(commands[1]);
-	line->pt1.y = strToInt(commands[2]);
-	line->pt2.x = strToInt(commands[3]);
-	line->pt2.y = strToInt(commands[4]);
-	ret = kstrtoull((unsigned char*)commands[5],0,&line->line_color);
-	
-	return 0;
+	if(strToInt(commands[1], &line->pt1.x) || strToInt(commands[2], &line->pt1.y) ||
+		strToInt(commands[3], &line->pt2.x) || strToInt(commands[4], &line->pt2.y))
+		return -1;
+	return parse_color(commands[5], &line->line_color, &line->line_alpha);
 }
 
+// Bresenham for all octants, every pixel of the line is visited exactly once
+// so translucent lines are blended evenly
 void LineOnScreen(const struct Line* line)
 {
-	int dx, dy, p, x=line->pt1.x, y=line->pt1.y,x_lim=line->pt2.x, incr=1;
-	dx = (int)line->pt2.x-(int)line->pt1.x;
-	if(dx < 0) 
-		dx *= -1;
-	dy = (int)line->pt2.y-(int)line->pt1.y;
-	if(dy < 0) 
-		dy *= -1;
-	if(line->pt1.x > line->pt2.x)
+	int x = line->pt1.x, y = line->pt1.y;
+	const int x2 = line->pt2.x, y2 = line->pt2.y;
+	const int dx = abs(x2 - x), dy = -abs(y2 - y);
+	const int sx = (x < x2) ? 1 : -1, sy = (y < y2) ? 1 : -1;
+	int err = dx + dy, e2;
+
+	if(dy == 0)
 	{
-		x = line->pt2.x;
-		y = line->pt2.y;
-		x_lim = line->pt1.x;
+		fill_span_alpha(y, min(x, x2), max(x, x2), (u32)line->line_color, line->line_alpha);
+		return;
 	}
-	if(!(y==line->pt1.y && line->pt1.y<=line->pt2.y) && !(y==line->pt2.y && line->pt2.y<=line->pt1.y))
-		incr = -1;
-
-	p = 2*dy-dx;
-	
-	while(x<=x_lim && y > 0)
+	for(;;)
 	{
-
-		tx_vir_buffer[640*y+x]=(u32)line->line_color;
-		if(p>=0)
-			y+=incr, p=p+ 2*dy - 2*dx;
-		else
-			p=p + 2*dy;
-		if(line->pt2.x != line->pt1.x)
-			x++;
-	}	
+		put_pixel_alpha(x, y, (u32)line->line_color, line->line_alpha);
+		if(x == x2 && y == y2)
+			break;
+		e2 = 2*err;
+		if(e2 >= dy)
+			err += dy, x += sx;
+		if(e2 <= dx)
+			err += dx, y += sy;
+	}
 }
@@ -0,0 +1,14 @@
+#include "Pix.h"
+
+// pix;x;y;COLOR[@ALPHA]
+int setPix(struct Pix* pix, const char* const* commands)
+{
+	if(strToInt(commands[1], &pix->pt.x) || strToInt(commands[2], &pix->pt.y))
+		return -1;
+	return parse_color(commands[3], &pix->pix_color, &pix->pix_alpha);
+}
+
+void PixOnScreen(const struct Pix* pix)
+{
+	put_pixel_alpha(pix->pt.x, pix->pt.y, (u32)pix->pix_color, pix->pix_alpha);
+}
@@ -0,0 +1,145 @@
+#include "Polygon.h"
+
+// points may lie off screen, but not so far that the edge arithmetic overflows
+#define POLY_COORD_MAX (16*640)
+
+// poly;x0;y0;x1;y1;...;COLOR[@ALPHA] - the number of points follows from the number of fields
+int setPolygon(struct Polygon* poly, const char* const* commands)
+{
+	unsigned int i, fields;
+	for(fields=1; fields<POLY_FIELDS && commands[fields][0]; ++fields);
+	if(fields == POLY_FIELDS && commands[fields][0])
+	{
+		printk(KERN_ERR "VGA_DMA: polygon has more than %d points!\n", POLY_MAX_POINTS);
+		return -1;
+	}
+	if(fields < 8 || (fields & 1))
+	{
+		printk(KERN_ERR "VGA_DMA: polygon needs at least 3 points and a color!\n");
+		return -1;
+	}
+	poly->n = (fields-2)/2;
+	for(i=0; i<poly->n; ++i)
+	{
+		if(strToInt(commands[1+2*i], &poly->pt[i].x) || strToInt(commands[2+2*i], &poly->pt[i].y))
+			return -1;
+		if(poly->pt[i].x > POLY_COORD_MAX || poly->pt[i].y > POLY_COORD_MAX)
+		{
+			printk(KERN_ERR "VGA_DMA: polygon point %u;%u is too far off screen!\n", poly->pt[i].x, poly->pt[i].y);
+			return -1;
+		}
+	}
+	return parse_color(commands[fields-1], &poly->poly_color, &poly->poly_alpha);
+}
+
+// tri;x0;y0;x1;y1;x2;y2;COLOR[@ALPHA]
+int setTriangle(struct Polygon* poly, const char* const* commands)
+{
+	if(commands[8][0])
+	{
+		printk(KERN_ERR "VGA_DMA: triangle takes exactly 3 points and a color!\n");
+		return -1;
+	}
+	return setPolygon(poly, commands);
+}
+
+// floor division which also rounds negative numerators down
+static inline int floorDiv(const int num, const int den)
+{
+	return (num >= 0) ? num/den : -((-num + den - 1)/den);
+}
+
+static int buildEdgeTable(const struct Polygon* poly, struct Edge* edges)
+{
+	unsigned int i, j, n = 0;
+	for(i=0; i<poly->n; ++i)
+	{
+		const struct Point* a = &poly->pt[i];
+		const struct Point* b = &poly->pt[(i+1) % poly->n];
+		struct Edge e;
+		int dx, dy, num;
+		if(a->y == b->y)
+			continue;
+		if(a->y > b->y)
+		{
+			const struct Point* tmp = a;
+			a = b, b = tmp;
+		}
+		dx = (int)b->x - (int)a->x;
+		dy = (int)b->y - (int)a->y;
+		e.ymin = a->y;
+		e.ymax = b->y;
+		// x = ceil(edge_x - 0.5) at y + 0.5, kept as x*den - err with 0 <= err < den
+		e.den = 2*dy;
+		num = 2*(int)a->x*dy + dx - dy;
+		e.x = -floorDiv(-num, e.den);
+		e.err = e.x*e.den - num;
+		e.xstep = floorDiv(2*dx, e.den);
+		e.errstep = 2*dx - e.xstep*e.den;
+		// insertion sort by ymin
+		for(j=n; j>0 && edges[j-1].ymin > e.ymin; --j)
+			edges[j] = edges[j-1];
+		edges[j] = e;
+		++n;
+	}
+	return n;
+}
+
+static inline void stepEdge(struct Edge* e)
+{
+	e->x += e->xstep;
+	e->err -= e->errstep;
+	if(e->err < 0)
+		e->x++, e->err += e->den;
+}
+
+// moves an edge down by rows scanlines at once
+static void advanceEdge(struct Edge* e, const int rows)
+{
+	int err, borrow;
+	if(rows <= 0)
+		return;
+	err = e->err - rows*e->errstep;
+	borrow = floorDiv(err, e->den);
+	e->x += rows*e->xstep - borrow;
+	e->err = err - borrow*e->den;
+}
+
+// active edge table scanline fill, a pixel is filled when its center is inside the polygon
+// (even-odd rule), so shared edges of neighbouring polygons are never drawn twice
+void PolygonOnScreen(const struct Polygon* poly)
+{
+	struct Edge edges[POLY_MAX_POINTS];
+	struct Edge* active[POLY_MAX_POINTS];
+	int i, j, y, n_edges = buildEdgeTable(poly, edges), n_active = 0, next = 0;
+
+	if(n_edges == 0)
+		return;
+	// rows above the clip box are skipped, the edges crossing it start where it starts
+	for(y = max(edges[0].ymin, clip.y0); y <= clip.y1 && (next < n_edges || n_active); ++y)
+	{
+		while(next < n_edges && edges[next].ymin <= y)
+		{
+			advanceEdge(&edges[next], y - edges[next].ymin);
+			active[n_active++] = &edges[next++];
+		}
+		for(i=0, j=0; i<n_active; ++i)
+			if(active[i]->ymax > y)
+				active[j++] = active[i];
+		n_active = j;
+		// edges keep their order between scanlines, insertion sort is almost free
+		for(i=1; i<n_active; ++i)
+		{
+			struct Edge* e = active[i];
+			for(j=i; j>0 && active[j-1]->x > e->x; --j)
+				active[j] = active[j-1];
+			active[j] = e;
+		}
+		for(i=0; i+1<n_active; i+=2)
+			fill_span_alpha(y, active[i]->x, active[i+1]->x - 1, (u32)poly->poly_color, poly->poly_alpha);
+		for(i=0; i<n_active; ++i)
+			stepEdge(active[i]);
+		if(n_active == 0 && next < n_edges)
+			y = edges[next].ymin - 1;
+	}
+}
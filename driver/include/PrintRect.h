@@ -9,14 +9,14 @@ void printRect(const struct Rect* rect)
 	printk("fill rect: %s\n", (rect->fill_rect == true) ? "true" : "false");
 }
 
-int setRect(struct Rect* rect, const char(* commands)[BUFF_SIZE] )
+// rect;x1;y1;x2;y2;COLOR[@ALPHA];FILL|NO
+int setRect(struct Rect* rect, const char* const* commands)
 {
-	int ret;
-	rect->pt1.x = strToInt(commands[1]);
-	rect->pt1.y = strToInt(commands[2]);
-	rect->pt2.x = strToInt(commands[3]);
-	rect->pt2.y = strToInt(commands[4]);
-	ret = kstrtoull((unsigned char*)commands[5],0,&rect->rect_color);
+	if(strToInt(commands[1], &rect->pt1.x) || strToInt(commands[2], &rect->pt1.y) ||
+		strToInt(commands[3], &rect->pt2.x) || strToInt(commands[4], &rect->pt2.y))
+		return -1;
+	if(parse_color(commands[5], &rect->rect_color, &rect->rect_alpha))
+		return -1;
 	
 	if(!strcmp(commands[6],"FILL") || !strcmp(commands[6],"fill"))
 		rect->fill_rect = true;
@@ -32,25 +32,32 @@ int setRect(struct Rect* rect, const char(* commands)[BUFF_SIZE] )
 
 void RectOnScreen(const struct Rect* rect)
 {
-	unsigned int startX=rect->pt2.x, endX=rect->pt1.x ,startY=rect->pt2.y, endY=rect->pt1.y, i,j;
-	if(!rect->fill_rect)
-	{
-		struct Line lines[4] = 
-		{ 
-			{{rect->pt1.x, rect->pt1.y}, {rect->pt2.x, rect->pt1.y}, rect->rect_color},
-			{{rect->pt1.x, rect->pt1.y}, {rect->pt1.x, rect->pt2.y}, rect->rect_color},
-			{{rect->pt1.x, rect->pt2.y}, {rect->pt2.x, rect->pt2.y}, rect->rect_color},
-			{{rect->pt2.x, rect->pt1.y}, {rect->pt2.x, rect->pt2.y}, rect->rect_color}
-		};
-		for(i=0;i<4;i++)
-			LineOnScreen(&lines[i]);
-		return;
-	}
+	unsigned int startX=rect->pt2.x, endX=rect->pt1.x ,startY=rect->pt2.y, endY=rect->pt1.y, x0, x1, y0, y1, j;
+	const u32 color = (u32)rect->rect_color;
 	if(rect->pt1.x < rect->pt2.x)
 		startX = rect->pt1.x, endX = rect->pt2.x;
 	if(rect->pt1.y < rect->pt2.y)
 		startY = rect->pt1.y, endY = rect->pt2.y;
-	for(i=startX; i<=endX; ++i)
-		for(j=startY; j<=endY; ++j)
-			tx_vir_buffer[640*j + i] = (u32)rect->rect_color;
+	// clipped before the loops, corners far off screen cost no rows
+	x0 = max(startX, (unsigned int)clip.x0), x1 = min(endX, (unsigned int)clip.x1);
+	y0 = max(startY, (unsigned int)clip.y0), y1 = min(endY, (unsigned int)clip.y1);
+	if(x0 > x1 || y0 > y1)
+		return;
+	if(!rect->fill_rect)
+	{
+		// outline as spans so the corners aren't blended twice
+		if(startY == y0)
+			fill_span_alpha(startY, x0, x1, color, rect->rect_alpha);
+		if(endY != startY && endY == y1)
+			fill_span_alpha(endY, x0, x1, color, rect->rect_alpha);
+		for(j=(startY == y0) ? y0+1 : y0; j<=y1 && j<endY; ++j)
+		{
+			if(startX == x0)
+				put_pixel_alpha(startX, j, color, rect->rect_alpha);
+			if(endX != startX && endX == x1)
+				put_pixel_alpha(endX, j, color, rect->rect_alpha);
+		}
+		return;
+	}
+	fill_rect_alpha(x0, y0, x1, y1, color, rect->rect_alpha);
 }
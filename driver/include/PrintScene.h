@@ -0,0 +1,191 @@
+#include "Scene.h"
+
+static LIST_HEAD(scene_objects);
+static DEFINE_HASHTABLE(scene_ids, SCENE_HASH_BITS);
+static struct Box scene_damage[SCENE_DAMAGE_RECTS];
+static int scene_ndamage = 0;
+static u32 scene_bckg = 0;
+
+// damaged areas are repainted on the next scene_flush, overlapping ones are merged
+// and when the list is full the area is merged into the rect which grows the least
+static void scene_add_damage(struct Box box)
+{
+	int i, best = 0, best_growth = INT_MAX;
+	box = box_on_screen(box);
+	if(box_empty(&box))
+		return;
+	for(i=0; i<scene_ndamage; ++i)
+		if(box_overlap(&scene_damage[i], &box))
+		{
+			box = box_union(&scene_damage[i], &box);
+			scene_damage[i--] = scene_damage[--scene_ndamage];
+		}
+	if(scene_ndamage < SCENE_DAMAGE_RECTS)
+	{
+		scene_damage[scene_ndamage++] = box;
+		return;
+	}
+	for(i=0; i<scene_ndamage; ++i)
+	{
+		const struct Box u = box_union(&scene_damage[i], &box);
+		const int growth = box_area(&u) - box_area(&scene_damage[i]);
+		if(growth < best_growth)
+			best = i, best_growth = growth;
+	}
+	scene_damage[best] = box_union(&scene_damage[best], &box);
+}
+
+// repaints the damaged areas: background first, then every object that reaches into the area in z-order
+static void scene_flush(void)
+{
+	struct SceneObject* obj;
+	struct Sprite* lifted;
+	const struct Shape** shapes;
+	unsigned int n = 0;
+	int i;
+	if(scene_ndamage == 0)
+		return;
+	// sprites stay on top, the ones over the damage are put back after the repaint
+	lifted = sprites_over(scene_damage, scene_ndamage);
+	if(lifted)
+		sprites_lift(lifted);
+	list_for_each_entry(obj, &scene_objects, list)
+		++n;
+	shapes = n ? kmalloc_array(n, sizeof(*shapes), GFP_KERNEL) : NULL;
+	for(i=0; i<scene_ndamage; ++i)
+	{
+		clip = scene_damage[i];
+		n = 0;
+		if(shapes)
+			list_for_each_entry(obj, &scene_objects, list)
+				if(box_overlap(&obj->shape.box, &clip))
+					shapes[n++] = &obj->shape;
+		if(shapes && !tile_render(shapes, n, &clip, &scene_bckg))
+			continue;
+		fill_rect_alpha(clip.x0, clip.y0, clip.x1, clip.y1, scene_bckg, 255);
+		list_for_each_entry(obj, &scene_objects, list)
+			if(box_overlap(&obj->shape.box, &clip))
+				ShapeOnScreen(&obj->shape);
+	}
+	kfree(shapes);
+	clip.x0 = 0, clip.y0 = 0, clip.x1 = MAX_W, clip.y1 = MAX_H;
+	scene_ndamage = 0;
+	if(lifted)
+		sprites_drop(&lifted->list);
+}
+
+static struct SceneObject* scene_find(const u32 id)
+{
+	struct SceneObject* obj;
+	hash_for_each_possible(scene_ids, obj, node, id)
+		if(obj->id == id)
+			return obj;
+	return NULL;
+}
+
+static void scene_delete(struct SceneObject* obj)
+{
+	scene_add_damage(obj->shape.box);
+	list_del(&obj->list);
+	hash_del(&obj->node);
+	kfree(obj);
+}
+
+static void scene_clear(void)
+{
+	struct SceneObject *obj, *tmp;
+	list_for_each_entry_safe(obj, tmp, &scene_objects, list)
+		scene_delete(obj);
+}
+
+// obj;new;ID;COMMAND... - keeps the shape of an ordinary drawing command as object ID on top of the others
+// obj;set;ID;COMMAND... - replaces the shape of the object, it keeps its place in z-order
+// obj;move;ID;DX;DY     - moves the object by DX, DY pixels (negative values move left/up)
+// obj;del;ID            - deletes the object
+// obj;clear             - deletes all objects
+// obj;bg;COLOR          - background the scene is painted on
+static int scene_command(const char* const* commands)
+{
+	struct SceneObject* obj;
+	struct Shape shape;
+	u32 id;
+
+	if(!strcmp(commands[1],"clear"))
+	{
+		scene_clear();
+		return 0;
+	}
+	if(!strcmp(commands[1],"bg"))
+	{
+		unsigned long long color;
+		u8 alpha;
+		struct Box screen = {0, 0, MAX_W, MAX_H};
+		if(parse_color(commands[2], &color, &alpha))
+			return -1;
+		scene_bckg = (u32)color;
+		scene_add_damage(screen);
+		return 0;
+	}
+	if(kstrtou32(commands[2], 0, &id))
+	{
+		printk(KERN_ERR "VGA_DMA: %s is not appropriate object id\n", commands[2]);
+		return -1;
+	}
+	obj = scene_find(id);
+
+	if(!strcmp(commands[1],"new"))
+	{
+		if(obj)
+		{
+			printk(KERN_ERR "VGA_DMA: object %u already exists\n", id);
+			return -1;
+		}
+		if(setShape(&shape, commands + 3))
+			return -1;
+		obj = kmalloc(sizeof(*obj), GFP_KERNEL);
+		if(!obj)
+			return -1;
+		obj->id = id;
+		obj->shape = shape;
+		list_add_tail(&obj->list, &scene_objects);
+		hash_add(scene_ids, &obj->node, id);
+		scene_add_damage(obj->shape.box);
+		return 0;
+	}
+	if(!obj)
+	{
+		printk(KERN_ERR "VGA_DMA: there's no object %u\n", id);
+		return -1;
+	}
+	if(!strcmp(commands[1],"del"))
+	{
+		scene_delete(obj);
+		return 0;
+	}
+	if(!strcmp(commands[1],"set"))
+	{
+		if(setShape(&shape, commands + 3))
+			return -1;
+	}
+	else if(!strcmp(commands[1],"move"))
+	{
+		int dx, dy;
+		if(kstrtoint(commands[3], 0, &dx) || kstrtoint(commands[4], 0, &dy))
+		{
+			printk(KERN_ERR "VGA_DMA: %s;%s is not appropriate offset\n", commands[3], commands[4]);
+			return -1;
+		}
+		shape = obj->shape;
+		if(moveShape(&shape, dx, dy))
+			return -1;
+	}
+	else
+	{
+		printk(KERN_ERR "VGA_DMA: %s is not appropriate object command\n", commands[1]);
+		return -1;
+	}
+	scene_add_damage(obj->shape.box);
+	obj->shape = shape;
+	scene_add_damage(obj->shape.box);
+	return 0;
+}
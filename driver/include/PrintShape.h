@@ -0,0 +1,165 @@
+#include "Shape.h"
+
+static inline bool box_empty(const struct Box* b)
+{
+	return b->x1 < b->x0 || b->y1 < b->y0;
+}
+
+static inline bool box_overlap(const struct Box* a, const struct Box* b)
+{
+	return a->x0 <= b->x1 && b->x0 <= a->x1 && a->y0 <= b->y1 && b->y0 <= a->y1;
+}
+
+static inline bool box_inside(const struct Box* in, const struct Box* out)
+{
+	return in->x0 >= out->x0 && in->x1 <= out->x1 && in->y0 >= out->y0 && in->y1 <= out->y1;
+}
+
+static inline struct Box box_union(const struct Box* a, const struct Box* b)
+{
+	struct Box u = {min(a->x0, b->x0), min(a->y0, b->y0), max(a->x1, b->x1), max(a->y1, b->y1)};
+	return u;
+}
+
+static inline struct Box box_intersect(const struct Box* a, const struct Box* b)
+{
+	struct Box i = {max(a->x0, b->x0), max(a->y0, b->y0), min(a->x1, b->x1), min(a->y1, b->y1)};
+	return i;
+}
+
+static inline int box_area(const struct Box* b)
+{
+	return (b->x1 - b->x0 + 1)*(b->y1 - b->y0 + 1);
+}
+
+static struct Box shape_bbox(const struct Shape* shape)
+{
+	struct Box box = {MAX_W+1, MAX_H+1, -1, -1};
+	unsigned int i;
+	switch(shape->type)
+	{
+		case state_TEXT:
+		{
+			const struct Word* word = &shape->word;
+			box.x0 = word->pt.x;
+			box.y0 = word->pt.y;
+			box.x1 = box.x0 + WordWidth(word) - 1;
+			box.y1 = box.y0 + font_cur->height*(word->big_font ? 2 : 1) - 1;
+		}
+		break;
+		case state_LINE:
+		case state_RECT:
+		{
+			// line and rect are both given by two points
+			const struct Point* pt1 = (shape->type == state_LINE) ? &shape->line.pt1 : &shape->rect.pt1;
+			const struct Point* pt2 = (shape->type == state_LINE) ? &shape->line.pt2 : &shape->rect.pt2;
+			box.x0 = min(pt1->x, pt2->x), box.x1 = max(pt1->x, pt2->x);
+			box.y0 = min(pt1->y, pt2->y), box.y1 = max(pt1->y, pt2->y);
+		}
+		break;
+		case state_PIX:
+			box.x0 = box.x1 = shape->pix.pt.x;
+			box.y0 = box.y1 = shape->pix.pt.y;
+		break;
+		case state_CIRC:
+			box.x0 = (int)shape->circle.pt.x - (int)shape->circle.r;
+			box.x1 = (int)shape->circle.pt.x + (int)shape->circle.r;
+			box.y0 = (int)shape->circle.pt.y - (int)shape->circle.r;
+			box.y1 = (int)shape->circle.pt.y + (int)shape->circle.r;
+		break;
+		case state_POLY:
+		case state_TRI:
+			for(i=0; i<shape->poly.n; ++i)
+			{
+				box.x0 = min(box.x0, (int)shape->poly.pt[i].x), box.x1 = max(box.x1, (int)shape->poly.pt[i].x);
+				box.y0 = min(box.y0, (int)shape->poly.pt[i].y), box.y1 = max(box.y1, (int)shape->poly.pt[i].y);
+			}
+		break;
+	}
+	return box;
+}
+
+// fills the shape from the fields of an ordinary drawing command
+static int setShape(struct Shape* shape, const char* const* commands)
+{
+	int ret;
+	shape->type = getState(commands[0]);
+	switch(shape->type)
+	{
+		case state_TEXT:
+			initWord(&shape->word);
+			ret = setWord(&shape->word, commands);
+		break;
+		case state_LINE: ret = setLine(&shape->line, commands); break;
+		case state_RECT: ret = setRect(&shape->rect, commands); break;
+		case state_CIRC: ret = setCircle(&shape->circle, commands); break;
+		case state_POLY: ret = setPolygon(&shape->poly, commands); break;
+		case state_TRI: ret = setTriangle(&shape->poly, commands); break;
+		case state_PIX: ret = setPix(&shape->pix, commands); break;
+		default:
+			printk(KERN_ERR "VGA_DMA: %s can't be kept as an object\n", commands[0]);
+			return -1;
+	}
+	if(ret)
+		return -1;
+	shape->box = shape_bbox(shape);
+	return 0;
+}
+
+// -1 if text doesn't fit the screen, like WordOnScreen
+static int ShapeOnScreen(const struct Shape* shape)
+{
+	switch(shape->type)
+	{
+		case state_TEXT: return WordOnScreen(&shape->word);
+		case state_LINE: LineOnScreen(&shape->line); break;
+		case state_RECT: RectOnScreen(&shape->rect); break;
+		case state_CIRC: CircleOnScreen(&shape->circle); break;
+		case state_POLY:
+		case state_TRI: PolygonOnScreen(&shape->poly); break;
+		case state_PIX: PixOnScreen(&shape->pix); break;
+	}
+	return 0;
+}
+
+static int movePoint(struct Point* pt, const int dx, const int dy)
+{
+	if((int)pt->x + dx < 0 || (int)pt->y + dy < 0)
+		return -1;
+	pt->x += dx;
+	pt->y += dy;
+	return 0;
+}
+
+static int moveShape(struct Shape* shape, const int dx, const int dy)
+{
+	int ret = 0;
+	unsigned int i;
+	switch(shape->type)
+	{
+		case state_TEXT: ret = movePoint(&shape->word.pt, dx, dy); break;
+		case state_LINE: ret = movePoint(&shape->line.pt1, dx, dy) | movePoint(&shape->line.pt2, dx, dy); break;
+		case state_RECT: ret = movePoint(&shape->rect.pt1, dx, dy) | movePoint(&shape->rect.pt2, dx, dy); break;
+		case state_CIRC: ret = movePoint(&shape->circle.pt, dx, dy); break;
+		case state_PIX: ret = movePoint(&shape->pix.pt, dx, dy); break;
+		case state_POLY:
+		case state_TRI:
+			for(i=0; i<shape->poly.n; ++i)
+				ret |= movePoint(&shape->poly.pt[i], dx, dy);
+		break;
+	}
+	if(ret)
+	{
+		printk(KERN_ERR "VGA_DMA: object can't be moved past the top or left edge of the screen\n");
+		return -1;
+	}
+	shape->box = shape_bbox(shape);
+	return 0;
+}
+
+static inline struct Box box_on_screen(struct Box box)
+{
+	box.x0 = max(box.x0, 0), box.y0 = max(box.y0, 0);
+	box.x1 = min(box.x1, MAX_W), box.y1 = min(box.y1, MAX_H);
+	return box;
+}
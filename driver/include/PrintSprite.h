@@ -0,0 +1,223 @@
+#include "Sprite.h"
+
+static LIST_HEAD(sprites);
+static u32* save_under_pool[SPRITE_POOL_SIZE];
+static int save_under_free = 0;
+
+static u32* save_under_get(void)
+{
+	if(save_under_free)
+		return save_under_pool[--save_under_free];
+	return kmalloc(SPRITE_SAVE_BYTES, GFP_KERNEL);
+}
+
+static void save_under_put(u32* under)
+{
+	if(save_under_free < SPRITE_POOL_SIZE)
+		save_under_pool[save_under_free++] = under;
+	else
+		kfree(under);
+}
+
+// saves the pixels under the sprite and draws it, the shape can't reach outside the saved area
+static void sprite_show(struct Sprite* spr)
+{
+	const struct Box screen = clip;
+	int y, w;
+	spr->saved = box_on_screen(spr->shape.box);
+	if(box_empty(&spr->saved))
+		return;
+	w = spr->saved.x1 - spr->saved.x0 + 1;
+	for(y=spr->saved.y0; y<=spr->saved.y1; ++y)
+		pk->copy32(spr->under + (y - spr->saved.y0)*w, tx_vir_buffer + 640*y + spr->saved.x0, w);
+	clip = spr->saved;
+	ShapeOnScreen(&spr->shape);
+	clip = screen;
+}
+
+static void sprite_hide(struct Sprite* spr)
+{
+	const struct Box empty = {0, 0, -1, -1};
+	int y, w;
+	if(box_empty(&spr->saved))
+		return;
+	w = spr->saved.x1 - spr->saved.x0 + 1;
+	for(y=spr->saved.y0; y<=spr->saved.y1; ++y)
+		pk->copy32(tx_vir_buffer + 640*y + spr->saved.x0, spr->under + (y - spr->saved.y0)*w, w);
+	spr->saved = empty;
+}
+
+// a sprite's saved pixels include the sprites below it, so sprites are hidden from the top down
+// to spr and shown again from the bottom up
+static void sprites_lift(struct Sprite* spr)
+{
+	struct Sprite* s;
+	list_for_each_entry_reverse(s, &sprites, list)
+	{
+		sprite_hide(s);
+		if(s == spr)
+			break;
+	}
+}
+
+static void sprites_drop(struct list_head* from)
+{
+	for(; from != &sprites; from = from->next)
+		sprite_show(list_entry(from, struct Sprite, list));
+}
+
+// lowest sprite reaching into any of the boxes, NULL if none does
+static struct Sprite* sprites_over(const struct Box* boxes, const int n)
+{
+	struct Sprite* s;
+	int i;
+	list_for_each_entry(s, &sprites, list)
+		for(i=0; i<n; ++i)
+			if(box_overlap(&s->saved, &boxes[i]))
+				return s;
+	return NULL;
+}
+
+// immediate drawing under the sprites: the ones over its area inside area are lifted, the
+// command is drawn and they're put back on top of it, so they save what it drew
+static int sprites_draw_under(const char* const* commands, const struct Box* area)
+{
+	const struct Box screen = clip;
+	struct Sprite* lifted;
+	struct Shape shape;
+	struct Box box;
+	int ret;
+
+	if(setShape(&shape, commands))
+		return -1;
+	box = box_intersect(&shape.box, area);
+	lifted = box_empty(&box) ? NULL : sprites_over(&box, 1);
+	if(lifted)
+		sprites_lift(lifted);
+	clip = *area;
+	ret = ShapeOnScreen(&shape);
+	clip = screen;
+	if(lifted)
+		sprites_drop(&lifted->list);
+	return ret;
+}
+
+static struct Sprite* sprite_find(const u32 id)
+{
+	struct Sprite* s;
+	list_for_each_entry(s, &sprites, list)
+		if(s->id == id)
+			return s;
+	return NULL;
+}
+
+static void sprite_delete(struct Sprite* spr)
+{
+	struct list_head* above = spr->list.next;
+	sprites_lift(spr);
+	list_del(&spr->list);
+	save_under_put(spr->under);
+	kfree(spr);
+	sprites_drop(above);
+}
+
+static void sprite_clear(void)
+{
+	while(!list_empty(&sprites))
+		sprite_delete(list_first_entry(&sprites, struct Sprite, list));
+	while(save_under_free)
+		kfree(save_under_pool[--save_under_free]);
+}
+
+static int sprite_fits(const struct Shape* shape)
+{
+	if(shape->box.x1 - shape->box.x0 >= SPRITE_MAX_W || shape->box.y1 - shape->box.y0 >= SPRITE_MAX_H)
+	{
+		printk(KERN_ERR "VGA_DMA: sprite can't be bigger than %dx%d\n", SPRITE_MAX_W, SPRITE_MAX_H);
+		return -1;
+	}
+	return 0;
+}
+
+// spr;new;ID;COMMAND... - sprite drawn by an ordinary drawing command, on top of everything else
+// spr;set;ID;COMMAND... - replaces the shape of the sprite
+// spr;move;ID;DX;DY     - moves the sprite by DX, DY pixels
+// spr;at;ID;X;Y         - moves the sprite so the top left corner of its area is at X, Y
+// spr;del;ID            - deletes the sprite and restores what was under it
+static int sprite_command(const char* const* commands)
+{
+	struct Sprite* spr;
+	struct Shape shape;
+	u32 id;
+
+	if(kstrtou32(commands[2], 0, &id))
+	{
+		printk(KERN_ERR "VGA_DMA: %s is not appropriate sprite id\n", commands[2]);
+		return -1;
+	}
+	spr = sprite_find(id);
+
+	if(!strcmp(commands[1],"new"))
+	{
+		if(spr)
+		{
+			printk(KERN_ERR "VGA_DMA: sprite %u already exists\n", id);
+			return -1;
+		}
+		if(setShape(&shape, commands + 3) || sprite_fits(&shape))
+			return -1;
+		spr = kmalloc(sizeof(*spr), GFP_KERNEL);
+		if(!spr)
+			return -1;
+		spr->under = save_under_get();
+		if(!spr->under)
+		{
+			kfree(spr);
+			return -1;
+		}
+		spr->id = id;
+		spr->shape = shape;
+		list_add_tail(&spr->list, &sprites);
+		sprite_show(spr);
+		return 0;
+	}
+	if(!spr)
+	{
+		printk(KERN_ERR "VGA_DMA: there's no sprite %u\n", id);
+		return -1;
+	}
+	if(!strcmp(commands[1],"del"))
+	{
+		sprite_delete(spr);
+		return 0;
+	}
+	if(!strcmp(commands[1],"set"))
+	{
+		if(setShape(&shape, commands + 3) || sprite_fits(&shape))
+			return -1;
+	}
+	else if(!strcmp(commands[1],"move") || !strcmp(commands[1],"at"))
+	{
+		int dx, dy;
+		if(kstrtoint(commands[3], 0, &dx) || kstrtoint(commands[4], 0, &dy))
+		{
+			printk(KERN_ERR "VGA_DMA: %s;%s is not appropriate position\n", commands[3], commands[4]);
+			return -1;
+		}
+		shape = spr->shape;
+		if(!strcmp(commands[1],"at"))
+			dx -= shape.box.x0, dy -= shape.box.y0;
+		if(moveShape(&shape, dx, dy))
+			return -1;
+	}
+	else
+	{
+		printk(KERN_ERR "VGA_DMA: %s is not appropriate sprite command\n", commands[1]);
+		return -1;
+	}
+	// restore the old area and draw at the new spot, sprites above are lifted and put back on top
+	sprites_lift(spr);
+	spr->shape = shape;
+	sprites_drop(&spr->list);
+	return 0;
+}
@@ -1,27 +1,41 @@
-#include "characters1.h"
-#include "characters2.h"
-
 #include "Word.h"
+#include "Font.h"
+#include "GlyphCache.h"
 #include "utils.h"
 
-static const bool(* b_ptr)[7][5] = NULL;
-static unsigned long long small_letter[7][5] = {{0}};
-static unsigned long long big_letter[14][10] = {{0}};
+// glyph rows plus the spacing column, 1 is background
+static u8 glyph_mask[BIG_FONT_H][BIG_FONT_W+1] = {{0}};
+// letter coverage 0-255 of the same pixels, used when the text is translucent or anti-aliased
+static u8 glyph_cov[BIG_FONT_H][BIG_FONT_W+1] = {{0}};
 
-static const bool(*const letter_forms[])[7][5] = 
+// next code point of the text, moves *s past it. Two byte UTF-8 sequences give Latin-1,
+// any other byte is taken as a Latin-1 character itself.
+static u8 text_next_char(const char** s)
 {
-	&A,&B,&C,&D,&E,&F,&G,&H,&I,&J,&K,&L,&M,&N,&O,&P,&Q,&R,&S,&T,&U,&V,&W,&X,&Y,&Z,
-	&a,&b,&c,&d,&e,&f,&g,&h,&i,&j,&k,&l,&m,&n,&o,&p,&q,&r,&s,&t,&u,&v,&w,&x,&y,&z,
-	&comma,&dot,&space,&questionnaire,&exclamation
-};
+	const u8* p = (const u8*)*s;
+	if((p[0] == 0xc2 || p[0] == 0xc3) && (p[1] & 0xc0) == 0x80)
+	{
+		*s += 2;
+		return ((p[0] & 0x1f) << 6) | (p[1] & 0x3f);
+	}
+	*s += 1;
+	return p[0];
+}
 
-static const char letters[] =
+static inline unsigned int glyph_step(const u8 character, const bool big_font)
 {
-	'A','B','C','D','E','F','G','H','I','J','K','L','M','N','O','P','Q','R','S','T','U','V','W','X','Y','Z',
-	'a','b','c','d','e','f','g','h','i','j','k','l','m','n','o','p','q','r','s','t','u','v','w','x','y','z',
-	',','.',' ','?','!'
-};
+	return font_cur->width[character]*(big_font ? 2 : 1);
+}
 
+// pixels the word takes by x axis, spacing columns included
+static unsigned int WordWidth(const struct Word* word)
+{
+	const char* s = word->chars;
+	unsigned int width = 0;
+	while(*s)
+		width += glyph_step(text_next_char(&s), word->big_font) + 1;
+	return width;
+}
 
 static void initWord(struct Word* word)
 {
@@ -31,14 +45,22 @@ static void initWord(struct Word* word)
 	word->big_font = false;
 	word->pt.x = 0, word->pt.y=0;
 	word->char_color=0, word->bckg_color=0;
+	word->char_alpha=255, word->bckg_alpha=255;
+	word->anti_alias = false;
 }
 
-static int setWord(struct Word* word, const char(* commands)[BUFF_SIZE])
+static int setWord(struct Word* word, const char* const* commands)
 {
-	int i;
-	for(i=0;i<strlen(commands[1]);++i)
-		word->chars[i] = commands[1][i];
-	
+	const u8* text = (const u8*)commands[1];
+	int n;
+	// the field can be of any length, the word keeps the first BUFF_SIZE-1 bytes
+	// and drops a UTF-8 character the cut went through
+	if(strlcpy(word->chars, commands[1], BUFF_SIZE) >= BUFF_SIZE)
+	{
+		for(n=BUFF_SIZE-1; n>0 && (text[n] & 0xc0) == 0x80; --n);
+		word->chars[n] = '\0';
+	}
+
 	if(!strcmp(commands[2],"big") || !strcmp(commands[2],"BIG") )
 		word->big_font = true;
 	else if(!strcmp(commands[2],"small") || !strcmp(commands[2],"SMALL") )
@@ -48,87 +70,140 @@ static int setWord(struct Word* word, const char(* commands)[BUFF_SIZE])
 		printk(KERN_ERR "%s this is not appropriate command\n",commands[2]);
 		return -1;
 	}	
-	word->pt.x = strToInt(commands[3]);
-	word->pt.y = strToInt(commands[4]);
-	i=kstrtoull((unsigned char*)commands[5],0,&word->char_color);
-	i=kstrtoull((unsigned char*)commands[6],0,&word->bckg_color);
-	return 0;
-}
-
-static int check_character(const char character)
-{
-	if( !(character >= 'A' && character <= 'Z') && !(character >= 'a' && character <= 'z') &&
-		character != ' ' && character != '!' && character != ',' && character != '?' && character != '.')
+	if(strToInt(commands[3], &word->pt.x) || strToInt(commands[4], &word->pt.y))
+		return -1;
+	if(parse_color(commands[5], &word->char_color, &word->char_alpha))
+		return -1;
+	if(!strcmp(commands[6],"none") || !strcmp(commands[6],"NONE"))
+		word->bckg_alpha = 0;
+	else if(parse_color(commands[6], &word->bckg_color, &word->bckg_alpha))
+		return -1;
+	if(!strcmp(commands[7],"aa") || !strcmp(commands[7],"AA"))
+		word->anti_alias = true;
+	else if(commands[7][0])
 	{
+		printk(KERN_ERR "%s this is not appropriate command\n",commands[7]);
 		return -1;
 	}
 	return 0;
 }
 
-static void choose_character(const char character, const bool(** ptr)[7][5])
-{
-	int i;
-	for(i=0;i<57;++i)
-		if(character == letters[i])
-		{
-			*ptr = letter_forms[i];
-			return;
-		}	
-}
-
-static void DoubleSizeMat(void)
+static void DoubleSizeMat(const int w, const int h)
 {
-	int i,j,c,d;
-	for(i=0;i<7;++i)
-		for(j=0;j<5;j++)
-			for(c=0;c<2;c++)
-				for(d=0;d<2;d++)
-					big_letter[2*i+c][2*j+d]=small_letter[i][j];
+	int i,j;
+	// in place, from the last pixel on so no source pixel is overwritten before it's read
+	for(i=h-1;i>=0;--i)
+		for(j=w-1;j>=0;--j)
+			glyph_mask[2*i][2*j] = glyph_mask[2*i][2*j+1] = glyph_mask[2*i+1][2*j] = glyph_mask[2*i+1][2*j+1] = glyph_mask[i][j];
+	for(i=0;i<2*h;++i)
+		glyph_mask[i][2*w] = 1;
 }
 
-static void AssignMatFromBool(const bool big_letter, const unsigned long long color_letter, const unsigned long long color_bckg)
+static void AssignMatFromFont(const u8 character, const bool big_letter)
 {
+	const u8* rows = font_cur->rows[character];
+	const int w = font_cur->width[character], h = font_cur->height;
 	int i,j;
-	for(i=0;i<7;++i)
-		for(j=0;j<5;++j)
-		{
-			small_letter[i][j] = ((*b_ptr)[i][j] == 1) ? color_bckg : color_letter;
-		}
+	for(i=0;i<h;++i)
+	{
+		for(j=0;j<w;++j)
+			glyph_mask[i][j] = !(rows[i] & (0x80 >> j));
+		glyph_mask[i][w] = 1;
+	}
 	if(big_letter)
 	{
-		DoubleSizeMat();
+		DoubleSizeMat(w, h);
 	}
 }
 
-static void CharOnScreen(const bool big_font, const unsigned int x_StartPos, const unsigned int y_StartPos, const unsigned int x_Step, const unsigned int y_Step, const unsigned long long Col_Bckg)
+// the doubled font is blocky, background pixels in the inner corner of a diagonal step
+// (both neighbours on the letter) get half coverage
+static void AntiAliasMat(const u8 character)
 {
-	unsigned int x,y,i,j;
-	for(y=y_StartPos, i=0; i<y_Step; ++i,++y)
-		for(x=x_StartPos, j=0; j<x_Step; ++x,++j)
+	const u8* rows = font_cur->rows[character];
+	const int w = font_cur->width[character], h = font_cur->height;
+	int i, j, ci, cj;
+	for(i=0;i<h;++i)
+		for(j=0;j<w;++j)
 		{
-			u32 rgb = (big_font == true) ? ((u32)big_letter[i][j]) : ((u32)small_letter[i][j]);
-			tx_vir_buffer[640*y + x] = rgb;
+			if(rows[i] & (0x80 >> j))
+				continue;
+			for(ci=0;ci<2;++ci)
+				for(cj=0;cj<2;++cj)
+				{
+					const int ni = ci ? i+1 : i-1, nj = cj ? j+1 : j-1;
+					if(ni >= 0 && ni < h && nj >= 0 && nj < w &&
+						(rows[ni] & (0x80 >> j)) && (rows[i] & (0x80 >> nj)))
+						glyph_cov[2*i+ci][2*j+cj] = 128;
+				}
 		}
-	x=x_StartPos+x_Step;
-	for(y=y_StartPos,i=0; i<y_Step; ++i,++y)
+}
+
+static void AssignCoverage(const u8 character, const bool big_letter, const bool anti_alias)
+{
+	int i,j;
+	for(i=0;i<BIG_FONT_H;++i)
+		for(j=0;j<=BIG_FONT_W;++j)
+			glyph_cov[i][j] = glyph_mask[i][j] ? 0 : 255;
+	if(big_letter && anti_alias)
+		AntiAliasMat(character);
+}
+
+static void CharOnScreen(const u8 character, const unsigned int x_StartPos, const unsigned int y_StartPos, const unsigned int x_Step, const unsigned int y_Step, const struct Word* word)
+{
+	int i;
+	const u32 Col_Letter = (u32)word->char_color, Col_Bckg = (u32)word->bckg_color;
+	const bool fast = word->char_alpha == 255 && word->bckg_alpha == 255 && !word->anti_alias;
+	// glyph columns c0..c1 (spacing column included) are inside the clip area
+	const int c0 = max(0, clip.x0 - (int)x_StartPos), c1 = min((int)x_Step, clip.x1 - (int)x_StartPos);
+	const struct GlyphTile* tile = NULL;
+	if(c0 > c1)
+		return;
+	if(fast)
+		tile = glyph_cache_find(character, word->big_font, Col_Letter, Col_Bckg);
+	if(!tile)
+	{
+		AssignMatFromFont(character, word->big_font);
+		if(fast)
+			tile = glyph_cache_add(character, word->big_font, Col_Letter, Col_Bckg, (const u8 (*)[BIG_FONT_W+1])glyph_mask, x_Step+1, y_Step);
+		else
+			AssignCoverage(character, word->big_font, word->anti_alias);
+	}
+	for(i=max(0, clip.y0 - (int)y_StartPos); i<(int)y_Step && (int)y_StartPos+i <= clip.y1; ++i)
 	{
-		tx_vir_buffer[640*y + x] = (u32)Col_Bckg;
+		u32* row = draw_row(y_StartPos+i) + x_StartPos + c0;
+		if(tile)
+		{
+			pk->copy32(row, tile->px[i] + c0, c1-c0+1);
+			continue;
+		}
+		if(fast)
+		{
+			pk->expand32(row, glyph_mask[i] + c0, c1-c0+1, Col_Bckg, Col_Letter);
+			continue;
+		}
+		if(word->bckg_alpha == 255)
+			pk->fill32(row, Col_Bckg, c1-c0+1);
+		else if(word->bckg_alpha)
+			pk->blend32(row, Col_Bckg, c1-c0+1, word->bckg_alpha);
+		pk->blendmask32(row, glyph_cov[i] + c0, c1-c0+1, Col_Letter, word->char_alpha);
 	}
 }
 
 static int WordOnScreen(const struct Word* word)
 {
-	unsigned int i, Y = word->pt.y, X=word->pt.x, strLen = strlen(word->chars),
-	x_step = (word->big_font == true) ? BIG_FONT_W : SMALL_FONT_W,
-	y_step = (word->big_font == true) ? BIG_FONT_H : SMALL_FONT_H,
-	checkX = X + x_step, checkY = Y + y_step;
+	const char* s = word->chars;
+	unsigned int Y = word->pt.y, X = word->pt.x,
+	y_step = font_cur->height*(word->big_font ? 2 : 1),
+	checkX = X + (*s ? glyph_step(text_next_char(&s), word->big_font) : 0), checkY = Y + y_step;
 	bool error=false;
-	for(i=0; i<strLen; ++i)
+	for(s = word->chars; *s; )
 	{
-		if(check_character(word->chars[i]) == -1)
+		const u8 character = text_next_char(&s);
+		if(!font_cur->width[character])
 		{
-			printk(KERN_ERR "VGA_DMA: %c cant be printed on screen, there's not this character on our library!\n",word->chars[i] );
-			error = true;	
+			printk(KERN_ERR "VGA_DMA: U+%04X cant be printed on screen, there's not this character in the font!\n", character);
+			error = true;
 		}
 	}
 
@@ -141,16 +216,18 @@ static int WordOnScreen(const struct Word* word)
 	if(error)
 		return -1;
 
-	for(i=0;i<strLen;++i)
+	for(s = word->chars; *s; )
 	{
-		choose_character(word->chars[i], &b_ptr);
-		AssignMatFromBool(word->big_font, word->char_color, word->bckg_color);
-		CharOnScreen(word->big_font, X, Y, x_step, y_step, word->bckg_color);
+		const u8 character = text_next_char(&s);
+		const unsigned int x_step = glyph_step(character, word->big_font);
+		const char* next = s;
+		// characters outside the clip area only move on
+		if((int)X <= clip.x1 && (int)(X + x_step) >= clip.x0 && (int)Y <= clip.y1 && (int)(Y + y_step) > clip.y0)
+			CharOnScreen(character, X, Y, x_step, y_step, word);
 		X += x_step+1;
-		b_ptr = NULL;
-		if(X+x_step > MAX_W && i < strLen-1)
+		if(*next && X + glyph_step(text_next_char(&next), word->big_font) > MAX_W)
 		{
-			printk(KERN_ERR "VGA_DMA: %c cant whole fit into screen by x axis!\n",word->chars[i]);
+			printk(KERN_ERR "VGA_DMA: %s cant whole fit into screen by x axis!\n", s);
 			break;
 		}
 	}
@@ -0,0 +1,165 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_RASTER_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_RASTER_H_
+
+#include <linux/workqueue.h>
+#include <linux/completion.h>
+#include <linux/percpu.h>
+#include <linux/cpumask.h>
+#include <linux/smp.h>
+
+#include "utils.h"
+
+// Big fills are split into horizontal bands, one per online CPU. The calling thread
+// rasterizes the first band and per-CPU work items the others. Drawing is serialized
+// by the driver lock, so one set of bands is enough.
+
+static unsigned int raster_min_pixels = 32768;
+module_param(raster_min_pixels, uint, 0644);
+MODULE_PARM_DESC(raster_min_pixels, "Fills smaller than this many pixels stay on the calling CPU (0 - never split)");
+
+struct RasterOp
+{
+	u32* dst;		// 640 pixels per row, the first one is row dst_y0
+	int dst_y0;
+	int x0, x1;		// already clipped
+	u32 color;
+	u8 alpha;
+};
+
+struct RasterBand
+{
+	struct work_struct work;
+	const struct RasterOp* op;
+	int y0, y1;
+	bool queued;
+	struct DrawChunk chunk;	// the worker has its own preemption points
+	struct completion done;
+};
+
+static DEFINE_PER_CPU(struct RasterBand, raster_bands);
+
+static void raster_band_rows(const struct RasterOp* op, int y0, const int y1, struct DrawChunk* chunk)
+{
+	const unsigned int n = op->x1 - op->x0 + 1;
+	for(; y0<=y1; ++y0)
+	{
+		u32* row = op->dst + 640*(y0 - op->dst_y0) + op->x0;
+		if(chunk == &draw_chunk)
+			draw_yield();
+		else
+			draw_chunk_yield(chunk);
+		if(op->alpha == 255)
+			pk->fill32(row, op->color, n);
+		else
+			pk->blend32(row, op->color, n, op->alpha);
+	}
+}
+
+static void raster_band_fn(struct work_struct* work)
+{
+	struct RasterBand* band = container_of(work, struct RasterBand, work);
+	raster_band_rows(band->op, band->y0, band->y1, &band->chunk);
+	complete(&band->done);
+}
+
+static void raster_fill_rows(const struct RasterOp* op, const int y0, const int y1)
+{
+	const unsigned long pixels = (unsigned long)(op->x1 - op->x0 + 1)*(y1 - y0 + 1);
+	const unsigned int ncpu = num_online_cpus();
+	int cpu, self, y, rows;
+
+	if(y1 < y0 || op->x1 < op->x0)
+		return;
+	if(raster_min_pixels == 0 || pixels < raster_min_pixels || ncpu < 2)
+	{
+		raster_band_rows(op, y0, y1, &draw_chunk);
+		return;
+	}
+	rows = DIV_ROUND_UP(y1 - y0 + 1, ncpu);
+	// the first band stays here, the CPU we run on is only a hint since we may migrate
+	self = raw_smp_processor_id();
+	y = y0 + rows;
+	for_each_online_cpu(cpu)
+	{
+		struct RasterBand* band;
+		if(cpu == self || y > y1)
+			continue;
+		band = per_cpu_ptr(&raster_bands, cpu);
+		band->op = op;
+		band->y0 = y;
+		band->y1 = min(y + rows - 1, y1);
+		band->queued = true;
+		reinit_completion(&band->done);
+		queue_work_on(cpu, system_highpri_wq, &band->work);
+		y += rows;
+	}
+	raster_band_rows(op, y0, min(y0 + rows - 1, y1), &draw_chunk);
+	// the calling thread picks up rows no CPU was left for
+	if(y <= y1)
+		raster_band_rows(op, y, y1, &draw_chunk);
+	for_each_possible_cpu(cpu)
+	{
+		struct RasterBand* band = per_cpu_ptr(&raster_bands, cpu);
+		if(!band->queued)
+			continue;
+		wait_for_completion(&band->done);
+		band->queued = false;
+	}
+}
+
+// filled rect on the screen, clipped to the clip box
+static void fill_rect_alpha(int x0, int y0, int x1, int y1, const u32 color, const u8 alpha)
+{
+	struct RasterOp op;
+	if(alpha == 0)
+		return;
+	op.dst = draw_tile ? draw_tile : tx_vir_buffer;
+	op.dst_y0 = draw_tile ? draw_tile_y0 : 0;
+	op.x0 = max(x0, clip.x0), op.x1 = min(x1, clip.x1);
+	op.color = color, op.alpha = alpha;
+	raster_fill_rows(&op, max(y0, clip.y0), min(y1, clip.y1));
+}
+
+static void raster_bench(void)
+{
+	u32* buff = vmalloc(640*480*sizeof(u32));
+	const unsigned int limit = raster_min_pixels, loops = 8;
+	struct RasterOp op = {buff, 0, 0, MAX_W, 0, 255};
+	u64 ns[2];
+	unsigned int i, j;
+	ktime_t start;
+
+	if(!buff || num_online_cpus() < 2)
+	{
+		vfree(buff);
+		return;
+	}
+	for(j=0; j<2; ++j)
+	{
+		raster_min_pixels = j ? 1 : 0;
+		start = ktime_get();
+		for(i=0; i<loops; ++i)
+			raster_fill_rows(&op, 0, MAX_H);
+		ns[j] = ktime_to_ns(ktime_sub(ktime_get(), start));
+	}
+	raster_min_pixels = limit;
+	vfree(buff);
+	printk(KERN_INFO "vga_dma: full screen fill %llu us on one CPU, %llu us on %u CPUs\n",
+		div64_u64(ns[0], loops*1000), div64_u64(ns[1], loops*1000), num_online_cpus());
+}
+
+static void raster_init(void)
+{
+	int cpu;
+	for_each_possible_cpu(cpu)
+	{
+		struct RasterBand* band = per_cpu_ptr(&raster_bands, cpu);
+		INIT_WORK(&band->work, raster_band_fn);
+		band->queued = false;
+		band->chunk.start = 0, band->chunk.rows = 0;
+		init_completion(&band->done);
+	}
+	raster_bench();
+}
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_RASTER_H_
@@ -7,6 +7,7 @@ struct Rect
 {
 	struct Point pt1, pt2;
 	unsigned long long rect_color;
+	u8 rect_alpha;
 	bool fill_rect;
 };
 
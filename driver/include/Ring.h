@@ -0,0 +1,135 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_RING_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_RING_H_
+
+#include <linux/mm.h>
+#include <linux/vmalloc.h>
+#include <linux/wait.h>
+#include <linux/list.h>
+
+#include "VgaIoctl.h"
+#include "GContext.h"
+#include "utils.h"
+
+// Every open file can map a submission ring (struct vga_ring) shared with its client.
+// The client is the only producer of sq entries and the driver of cq entries, so both
+// sides go without locks, indexes are published with release and read with acquire.
+// The driver keeps its own copies of the indexes it owns, the shared ones are only
+// reported to the client.
+
+#define RING_PGOFF (VGA_RING_MMAP_OFFSET >> PAGE_SHIFT)
+#define RING_SIZE PAGE_ALIGN(sizeof(struct vga_ring))
+#define RING_MASK (VGA_RING_ENTRIES - 1)
+
+struct VgaRing
+{
+	struct vga_ring* shared;	// mapped by the client
+	struct GContext* gc;		// commands run with the context of the file
+	u32 sq_head, cq_tail;
+	bool polled;			// on ring_polled, taken after every frame
+	struct list_head list;
+	wait_queue_head_t wait;		// poll() of the file waits here for completions
+};
+
+static LIST_HEAD(ring_polled);		// vga_lock
+static unsigned int ring_pollers = 0;	// read by dma_isr
+
+static struct VgaRing* ring_alloc(struct GContext* gc)
+{
+	struct VgaRing* ring = kzalloc(sizeof(*ring), GFP_KERNEL);
+	if(!ring)
+		return NULL;
+	// zeroed, the client sees empty queues
+	ring->shared = vmalloc_user(RING_SIZE);
+	if(!ring->shared)
+	{
+		kfree(ring);
+		return NULL;
+	}
+	ring->gc = gc;
+	INIT_LIST_HEAD(&ring->list);
+	init_waitqueue_head(&ring->wait);
+	return ring;
+}
+
+static void ring_set_poll(struct VgaRing* ring, const bool poll)
+{
+	if(poll == ring->polled)
+		return;
+	if(poll)
+		list_add_tail(&ring->list, &ring_polled);
+	else
+		list_del_init(&ring->list);
+	ring->polled = poll;
+	WRITE_ONCE(ring_pollers, ring_pollers + (poll ? 1 : -1));
+}
+
+// the file is released only when no mapping is left, so the ring goes with it
+static void ring_free(struct VgaRing* ring)
+{
+	if(!ring)
+		return;
+	ring_set_poll(ring, false);
+	vfree(ring->shared);
+	kfree(ring);
+}
+
+// maps the ring of the file, it's made on the first mapping
+static int ring_mmap(struct GContext* gc, struct vm_area_struct* vma)
+{
+	if(vma->vm_end - vma->vm_start > RING_SIZE)
+		return -EINVAL;
+	if(!gc->ring)
+		gc->ring = ring_alloc(gc);
+	if(!gc->ring)
+		return -ENOMEM;
+	return remap_vmalloc_range(vma, gc->ring->shared, 0);
+}
+
+static inline bool ring_pending(const struct VgaRing* ring)
+{
+	return smp_load_acquire(&ring->shared->sq_tail) != ring->sq_head;
+}
+
+static inline bool ring_completions(const struct VgaRing* ring)
+{
+	return READ_ONCE(ring->shared->cq_head) != ring->cq_tail;
+}
+
+// runs the queued entries with the driver lock held, returns how many were run.
+// An entry is copied out before it's parsed, the client may already be rewriting it.
+static int ring_run(struct VgaRing* ring)
+{
+	struct vga_ring* shared = ring->shared;
+	const char* commands[CMD_FIELDS+1];
+	char line[VGA_RING_CMD_SIZE+1];
+	const u32 tail = smp_load_acquire(&shared->sq_tail);
+	int n = 0;
+
+	// a bad tail from the client runs at most one ring of garbage
+	while(ring->sq_head != tail && n < VGA_RING_ENTRIES)
+	{
+		const struct vga_ring_sqe* sqe = &shared->sq[ring->sq_head & RING_MASK];
+		struct vga_ring_cqe* cqe;
+		unsigned int len;
+		// no room for the completion, the client has to take some first
+		if(ring->cq_tail - smp_load_acquire(&shared->cq_head) >= VGA_RING_ENTRIES)
+			break;
+		len = min_t(unsigned int, READ_ONCE(sqe->len), VGA_RING_CMD_SIZE);
+		memcpy(line, sqe->cmd, len);
+		line[len] = '\0';
+		if(len && line[len-1] == '\n')
+			line[len-1] = '\0';
+		cqe = &shared->cq[ring->cq_tail & RING_MASK];
+		cqe->tag = READ_ONCE(sqe->tag);
+		cqe->result = (*line && exec_command(line, commands, ring->gc)) ? -EINVAL : 0;
+		// the entry can be reused once sq_head passed it
+		smp_store_release(&shared->sq_head, ++ring->sq_head);
+		smp_store_release(&shared->cq_tail, ++ring->cq_tail);
+		++n;
+	}
+	if(n)
+		wake_up_interruptible(&ring->wait);
+	return n;
+}
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_RING_H_
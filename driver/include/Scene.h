@@ -0,0 +1,20 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_SCENE_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_SCENE_H_
+
+#include <linux/list.h>
+#include <linux/hashtable.h>
+
+#include "Shape.h"
+
+#define SCENE_HASH_BITS 6
+#define SCENE_DAMAGE_RECTS 8
+
+struct SceneObject
+{
+	struct list_head list;	// z-order, the last object is on top
+	struct hlist_node node;	// lookup by id
+	u32 id;
+	struct Shape shape;
+};
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_SCENE_H_
@@ -0,0 +1,28 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_SHAPE_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_SHAPE_H_
+
+#include "utils.h"
+#include "Word.h"
+#include "Line.h"
+#include "Rect.h"
+#include "Circle.h"
+#include "Polygon.h"
+#include "Pix.h"
+
+// any primitive that can be kept and drawn again
+struct Shape
+{
+	state_t type;
+	struct Box box;		// screen area the shape covers
+	union
+	{
+		struct Word word;
+		struct Line line;
+		struct Rect rect;
+		struct Circle circle;
+		struct Polygon poly;
+		struct Pix pix;
+	};
+};
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_SHAPE_H_
@@ -0,0 +1,22 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_SPRITE_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_SPRITE_H_
+
+#include <linux/list.h>
+
+#include "Shape.h"
+
+#define SPRITE_MAX_W 64
+#define SPRITE_MAX_H 64
+#define SPRITE_SAVE_BYTES (SPRITE_MAX_W*SPRITE_MAX_H*4)
+#define SPRITE_POOL_SIZE 8 // free save-under buffers kept for reuse
+
+struct Sprite
+{
+	struct list_head list;	// z-order, sprites are above the scene and the last one is on top
+	u32 id;
+	struct Shape shape;
+	struct Box saved;	// screen area held in under, empty while the sprite is hidden
+	u32* under;		// pixels the sprite covers, rows of saved width
+};
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_SPRITE_H_
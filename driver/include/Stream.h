@@ -0,0 +1,84 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_STREAM_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_STREAM_H_
+
+#include <linux/uio.h>
+
+#include "GContext.h"
+#include "utils.h"
+
+// splice(), sendfile() and writev() hand the driver a stream cut at page and pipe buffer
+// boundaries instead of whole commands. The data is copied from the iterator straight
+// into the file's stream buffer, every command completed by a newline is run from there
+// and an unfinished one stays at the start of the buffer for the rest of it.
+
+#define STREAM_BUFF_SIZE 4096 // longest command, the same as one write chunk
+
+struct VgaStream
+{
+	size_t len;		// bytes in buf, no newline among them
+	bool skip;		// a too long command is dropped up to its newline
+	char buf[STREAM_BUFF_SIZE+1];
+};
+
+static struct VgaStream* stream_alloc(void)
+{
+	return kzalloc(sizeof(struct VgaStream), GFP_KERNEL);
+}
+
+// runs the complete commands of the buffer with the driver lock held
+static void stream_run(struct GContext* gc)
+{
+	struct VgaStream* st = gc->stream;
+	const char* commands[CMD_FIELDS+1];
+	char *line = st->buf, *nl;
+
+	while((nl = memchr(line, '\n', st->buf + st->len - line)))
+	{
+		*nl = '\0';
+		if(st->skip)
+			st->skip = false;
+		else if(*line)
+			exec_command(line, commands, gc);
+		line = nl + 1;
+	}
+	st->len -= line - st->buf;
+	if(st->skip)
+		st->len = 0;
+	else if(st->len == STREAM_BUFF_SIZE)
+	{
+		printk(KERN_ERR "vga_dma: command longer than %d bytes\n", STREAM_BUFF_SIZE);
+		st->len = 0;
+		st->skip = true;
+	}
+	else
+		memmove(st->buf, line, st->len);
+}
+
+static int stream_write(struct GContext* gc, struct iov_iter* from)
+{
+	struct VgaStream* st = gc->stream;
+	while(iov_iter_count(from))
+	{
+		const size_t n = copy_from_iter(st->buf + st->len, STREAM_BUFF_SIZE - st->len, from);
+		if(!n)
+			return -EFAULT;
+		st->len += n;
+		stream_run(gc);
+	}
+	return 0;
+}
+
+// the file is closed, a last command without a newline still runs
+static void stream_end(struct GContext* gc)
+{
+	struct VgaStream* st = gc->stream;
+	const char* commands[CMD_FIELDS+1];
+	if(st->len && !st->skip)
+	{
+		st->buf[st->len] = '\0';
+		exec_command(st->buf, commands, gc);
+	}
+	st->len = 0;
+}
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_STREAM_H_
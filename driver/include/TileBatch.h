@@ -0,0 +1,119 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_TILEBATCH_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_TILEBATCH_H_
+
+#include "Shape.h"
+
+// Batches with many shapes are drawn tile by tile: every shape is binned into the 32x32 tiles
+// its box reaches, then each tile is drawn in a scratch tile which stays in the cache and is
+// written to the frame once, instead of every shape sweeping over the frame on its own.
+
+#define TILE_SIZE 32
+#define TILES_X ((MAX_W + TILE_SIZE) / TILE_SIZE)
+#define TILES_Y ((MAX_H + TILE_SIZE) / TILE_SIZE)
+
+static unsigned int tile_min_shapes = 4;
+module_param(tile_min_shapes, uint, 0644);
+MODULE_PARM_DESC(tile_min_shapes, "Batches with at least this many shapes are drawn tile by tile (0 - never)");
+
+// the drawing code addresses rows 640 pixels apart, so the scratch tile keeps that stride,
+// only 32 pixels of each row are touched
+static u32 tile_scratch[TILE_SIZE*640];
+static unsigned int tile_first[TILES_X*TILES_Y + 1];	// bin of tile t is bins[tile_first[t] .. tile_first[t+1]-1]
+static unsigned int tile_next[TILES_X*TILES_Y];
+
+// an opaque filled rect over the whole tile hides everything drawn there before it
+static inline bool shape_covers(const struct Shape* shape, const struct Box* box)
+{
+	return shape->type == state_RECT && shape->rect.fill_rect && shape->rect.rect_alpha == 255 && box_inside(box, &shape->box);
+}
+
+// draws the shapes in order inside area (and the clip box), bckg != NULL paints the area first,
+// returns -1 without drawing anything when the batch is too small to bin or there's no memory
+// for the bins, the caller then draws the shapes one by one
+static int tile_render(const struct Shape** shapes, const unsigned int n, const struct Box* area, const u32* bckg)
+{
+	u32* const frame = tx_vir_buffer;
+	const struct Box outer = clip;
+	const struct Box a = box_intersect(area, &outer);
+	unsigned int* bins;
+	unsigned int i, k, total = 0;
+	int tx, ty, y;
+
+	if(tile_min_shapes == 0 || n < tile_min_shapes)
+		return -1;
+	if(box_empty(&a))
+		return 0;
+
+	memset(tile_first, 0, sizeof(tile_first));
+	for(i=0; i<n; ++i)
+	{
+		const struct Box b = box_intersect(&shapes[i]->box, &a);
+		if(box_empty(&b))
+			continue;
+		for(ty=b.y0/TILE_SIZE; ty<=b.y1/TILE_SIZE; ++ty)
+			for(tx=b.x0/TILE_SIZE; tx<=b.x1/TILE_SIZE; ++tx)
+				tile_first[ty*TILES_X + tx + 1]++, total++;
+	}
+	bins = kvmalloc_array(max(total, 1u), sizeof(*bins), GFP_KERNEL);
+	if(!bins)
+		return -1;
+	for(k=0; k<TILES_X*TILES_Y; ++k)
+	{
+		tile_first[k+1] += tile_first[k];
+		tile_next[k] = tile_first[k];
+	}
+	for(i=0; i<n; ++i)
+	{
+		const struct Box b = box_intersect(&shapes[i]->box, &a);
+		if(box_empty(&b))
+			continue;
+		for(ty=b.y0/TILE_SIZE; ty<=b.y1/TILE_SIZE; ++ty)
+			for(tx=b.x0/TILE_SIZE; tx<=b.x1/TILE_SIZE; ++tx)
+				bins[tile_next[ty*TILES_X + tx]++] = i;
+	}
+
+	for(ty=a.y0/TILE_SIZE; ty<=a.y1/TILE_SIZE; ++ty)
+		for(tx=a.x0/TILE_SIZE; tx<=a.x1/TILE_SIZE; ++tx)
+		{
+			const unsigned int t = ty*TILES_X + tx, last = tile_first[t+1];
+			const struct Box tile = {max(tx*TILE_SIZE, a.x0), max(ty*TILE_SIZE, a.y0),
+				min(tx*TILE_SIZE + TILE_SIZE-1, a.x1), min(ty*TILE_SIZE + TILE_SIZE-1, a.y1)};
+			const unsigned int w = tile.x1 - tile.x0 + 1;
+			// the frame is read into the scratch and written back without counting, the
+			// background and the shapes count where they'll end up
+			const struct PixelKernels* k_raw = pk_uncounted();
+			unsigned int start = tile_first[t];
+
+			if(start == last && !bckg)
+				continue;
+			for(k=last; k>start; --k)
+				if(shape_covers(shapes[bins[k-1]], &tile))
+					break;
+			draw_tile = tile_scratch;
+			draw_tile_y0 = tile.y0;
+			if(k > start)
+				start = k-1;
+			else
+				for(y=tile.y0; y<=tile.y1; ++y)
+				{
+					u32* const row = tile_scratch + 640*(y - tile.y0) + tile.x0;
+					if(bckg)
+						pk->fill32(row, *bckg, w);
+					else
+						k_raw->copy32(row, frame + 640*y + tile.x0, w);
+				}
+
+			draw_yield();
+			clip = tile;
+			for(k=start; k<last; ++k)
+				ShapeOnScreen(shapes[bins[k]]);
+			draw_tile = NULL;
+			for(y=tile.y0; y<=tile.y1; ++y)
+				k_raw->copy32(frame + 640*y + tile.x0, tile_scratch + 640*(y - tile.y0) + tile.x0, w);
+		}
+	clip = outer;
+	kvfree(bins);
+	return 0;
+}
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_TILEBATCH_H_
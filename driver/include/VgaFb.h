@@ -0,0 +1,318 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_VGAFB_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_VGAFB_H_
+
+#include <linux/fb.h>
+#include <linux/console.h>
+#include <linux/mutex.h>
+#include <linux/dma-mapping.h>
+#include <asm/simd.h>
+
+#include "utils.h"
+#include "Pan.h"
+
+// fbdev personality: /dev/fbN scans out of the same frame buffer as /dev/vga_dma, so fbcon,
+// fbset and other framebuffer clients draw zero-copy. Acceleration hooks use the pixel kernels.
+// They can be called from atomic console context, so they don't take the driver lock, don't
+// use the clip box of the text protocol and fall back to the scalar kernels where the FPU
+// can't be taken. yres_virtual is virtual_lines, panning
+// moves the same line the pan command does. While the frame buffer is dropped by blanking
+// the fb is suspended, fbcon and fb read/write leave it alone until it's allocated again.
+
+static bool fbdev = true;
+module_param(fbdev, bool, 0444);
+MODULE_PARM_DESC(fbdev, "Register the display as a framebuffer device too");
+
+#if IS_ENABLED(CONFIG_FB)
+
+#define VGA_FB_BLIT_CHUNK 64
+
+static struct fb_info* vga_fb = NULL;
+static dma_addr_t vga_fb_dma;
+static u32 vga_fb_palette[16];
+static atomic_t vga_fb_maps = ATOMIC_INIT(0);
+static DEFINE_MUTEX(vga_fb_map_lock);	// a mapping isn't made while the fb is suspended
+
+static const struct fb_fix_screeninfo vga_fb_fix =
+{
+	.id = "vga_dma",
+	.type = FB_TYPE_PACKED_PIXELS,
+	.visual = FB_VISUAL_TRUECOLOR,
+	.line_length = 640*4,
+	.ypanstep = 1,
+	.accel = FB_ACCEL_NONE,
+};
+
+static const struct fb_var_screeninfo vga_fb_var =
+{
+	.xres = 640, .yres = 480,
+	.xres_virtual = 640, .yres_virtual = 480,
+	.bits_per_pixel = 32,
+	.red = {16, 8, 0}, .green = {8, 8, 0}, .blue = {0, 8, 0}, .transp = {24, 0, 0},
+	.activate = FB_ACTIVATE_NOW,
+	.height = -1, .width = -1,
+	.vmode = FB_VMODE_NONINTERLACED,
+};
+
+// fb colors are palette indexes for truecolor consoles
+static inline u32 vga_fb_color(const struct fb_info* info, const u32 color)
+{
+	return (info->fix.visual == FB_VISUAL_TRUECOLOR && color < 16) ? ((u32*)info->pseudo_palette)[color] : color;
+}
+
+// the kernels under the overdraw wrappers, the hooks count their pixels themselves
+// so the scalar fallback and the XOR rows are counted too
+static inline const struct PixelKernels* vga_fb_kernels(void)
+{
+	return may_use_simd() ? pk_uncounted() : &scalar_kernels;
+}
+
+// fb pixels count from line 0 of the frame buffer, not from the line the protocol draws to,
+// they're moved into the window the heatmap shows
+static inline void vga_fb_count(const struct fb_info* info, const u32* dst, const unsigned int n)
+{
+	if(READ_ONCE(overdraw_on))
+		overdraw_add_at((long)(dst - (const u32*)info->screen_base) - (long)(READ_ONCE(tx_vir_buffer) - vga_base), n);
+}
+
+// clips x, y, w, h to the frame buffer, false if nothing is left
+static bool vga_fb_clip(u32* x, u32* y, u32* w, u32* h)
+{
+	if(*x > MAX_W || *y >= virtual_lines)
+		return false;
+	*w = min_t(u32, *w, MAX_W + 1 - *x);
+	*h = min_t(u32, *h, virtual_lines - *y);
+	return *w && *h;
+}
+
+static int vga_fb_check_var(struct fb_var_screeninfo* var, struct fb_info* info)
+{
+	const u32 yoffset = var->yoffset;
+	if(var->xres != 640 || var->yres != 480 || var->bits_per_pixel != 32 || var->yres_virtual > virtual_lines)
+		return -EINVAL;
+	*var = vga_fb_var;
+	var->yres_virtual = virtual_lines;
+	var->yoffset = min_t(u32, yoffset, virtual_lines - var->yres);
+	return 0;
+}
+
+static int vga_fb_pan_display(struct fb_var_screeninfo* var, struct fb_info* info)
+{
+	if(var->xoffset || var->yoffset + var->yres > virtual_lines)
+		return -EINVAL;
+	WRITE_ONCE(pan_y, var->yoffset);
+	return 0;
+}
+
+static int vga_fb_setcolreg(unsigned regno, unsigned red, unsigned green, unsigned blue, unsigned transp, struct fb_info* info)
+{
+	if(regno >= 16)
+		return -EINVAL;
+	((u32*)info->pseudo_palette)[regno] = ((red >> 8) << 16) | ((green >> 8) << 8) | (blue >> 8);
+	return 0;
+}
+
+static void vga_fb_fillrect(struct fb_info* info, const struct fb_fillrect* rect)
+{
+	u32 x = rect->dx, y = rect->dy, w = rect->width, h = rect->height, i;
+	const u32 color = vga_fb_color(info, rect->color);
+	const struct PixelKernels* kern = vga_fb_kernels();
+	if(!vga_fb_clip(&x, &y, &w, &h))
+		return;
+	for(; h; --h, ++y)
+	{
+		u32* row = (u32*)info->screen_base + 640*y + x;
+		vga_fb_count(info, row, w);
+		if(rect->rop == ROP_XOR)
+			for(i=0; i<w; ++i)
+				row[i] ^= color;
+		else
+			kern->fill32(row, color, w);
+	}
+}
+
+static void vga_fb_copyarea(struct fb_info* info, const struct fb_copyarea* area)
+{
+	u32 dx = area->dx, dy = area->dy, w = area->width, h = area->height;
+	u32 sx = area->sx, sy = area->sy, i;
+	u32* fb = (u32*)info->screen_base;
+	const struct PixelKernels* kern = vga_fb_kernels();
+	if(!vga_fb_clip(&dx, &dy, &w, &h) || !vga_fb_clip(&sx, &sy, &w, &h))
+		return;
+	// rows are copied away from the overlap
+	for(i=0; i<h; ++i)
+	{
+		const u32 r = (dy > sy) ? h-1-i : i;
+		u32* dst = fb + 640*(dy+r) + dx;
+		const u32* src = fb + 640*(sy+r) + sx;
+		vga_fb_count(info, dst, w);
+		if(dy == sy)
+			memmove(dst, src, w*4);
+		else
+			kern->copy32(dst, src, w);
+	}
+}
+
+// monochrome images (console glyphs) are expanded by the glyph kernel
+static void vga_fb_imageblit(struct fb_info* info, const struct fb_image* image)
+{
+	u32 x = image->dx, y = image->dy, w = image->width, h = image->height, i, j, k;
+	const u32 pitch = DIV_ROUND_UP(image->width, 8);
+	u8 mask[VGA_FB_BLIT_CHUNK];
+	const struct PixelKernels* kern = vga_fb_kernels();
+	u32 fg, bg;
+	if(image->depth != 1)
+	{
+#if IS_ENABLED(CONFIG_FB_SYS_IMAGEBLIT)
+		sys_imageblit(info, image);
+#endif
+		return;
+	}
+	if(!vga_fb_clip(&x, &y, &w, &h))
+		return;
+	fg = vga_fb_color(info, image->fg_color);
+	bg = vga_fb_color(info, image->bg_color);
+	for(i=0; i<h; ++i)
+	{
+		const u8* bits = image->data + i*pitch;
+		u32* row = (u32*)info->screen_base + 640*(y+i) + x;
+		vga_fb_count(info, row, w);
+		for(j=0; j<w; j+=VGA_FB_BLIT_CHUNK)
+		{
+			const u32 n = min_t(u32, w - j, VGA_FB_BLIT_CHUNK);
+			for(k=0; k<n; ++k)
+				mask[k] = (bits[(j+k) >> 3] >> (7 - ((j+k) & 7))) & 1;
+			kern->expand32(row + j, mask, n, fg, bg);
+		}
+	}
+}
+
+static void vga_fb_vm_open(struct vm_area_struct* vma)
+{
+	atomic_inc(&vga_fb_maps);
+}
+
+static void vga_fb_vm_close(struct vm_area_struct* vma)
+{
+	atomic_dec(&vga_fb_maps);
+}
+
+static const struct vm_operations_struct vga_fb_vm_ops =
+{
+	.open = vga_fb_vm_open,
+	.close = vga_fb_vm_close,
+};
+
+static int vga_fb_mmap(struct fb_info* info, struct vm_area_struct* vma)
+{
+	int ret;
+	if(vma->vm_end - vma->vm_start > info->fix.smem_len)
+		return -EINVAL;
+	mutex_lock(&vga_fb_map_lock);
+	if(info->state != FBINFO_STATE_RUNNING)
+		ret = -EBUSY;
+	else
+		ret = dma_mmap_coherent(NULL, vma, info->screen_base, vga_fb_dma, vma->vm_end - vma->vm_start);
+	if(!ret)
+	{
+		vma->vm_ops = &vga_fb_vm_ops;
+		vga_fb_vm_open(vma);
+	}
+	mutex_unlock(&vga_fb_map_lock);
+	return ret;
+}
+
+static struct fb_ops vga_fb_ops =
+{
+	.owner = THIS_MODULE,
+	.fb_check_var = vga_fb_check_var,
+	.fb_pan_display = vga_fb_pan_display,
+	.fb_setcolreg = vga_fb_setcolreg,
+	.fb_fillrect = vga_fb_fillrect,
+	.fb_copyarea = vga_fb_copyarea,
+	.fb_imageblit = vga_fb_imageblit,
+	.fb_mmap = vga_fb_mmap,
+};
+
+static int vga_fb_init(struct device* parent, u32* vir, const dma_addr_t phy, const u32 size)
+{
+	int ret;
+	if(!fbdev)
+		return 0;
+	vga_fb = framebuffer_alloc(0, parent);
+	if(!vga_fb)
+		return -ENOMEM;
+	vga_fb_dma = phy;
+	vga_fb->fbops = &vga_fb_ops;
+	vga_fb->fix = vga_fb_fix;
+	vga_fb->fix.smem_start = phy;
+	vga_fb->fix.smem_len = size;
+	vga_fb->var = vga_fb_var;
+	vga_fb->var.yres_virtual = virtual_lines;
+	vga_fb->screen_base = (char __iomem*)vir;
+	vga_fb->screen_size = size;
+	vga_fb->pseudo_palette = vga_fb_palette;
+	vga_fb->flags = FBINFO_DEFAULT;
+	ret = register_framebuffer(vga_fb);
+	if(ret)
+	{
+		printk(KERN_ERR "VGA_DMA: could not register framebuffer (%d)\n", ret);
+		framebuffer_release(vga_fb);
+		vga_fb = NULL;
+		return ret;
+	}
+	printk(KERN_INFO "VGA_DMA: registered as framebuffer fb%d\n", vga_fb->node);
+	return 0;
+}
+
+static void vga_fb_exit(void)
+{
+	if(!vga_fb)
+		return;
+	unregister_framebuffer(vga_fb);
+	framebuffer_release(vga_fb);
+	vga_fb = NULL;
+}
+
+// the frame buffer is about to be freed, refused while a client has it mapped
+static int vga_fb_suspend(void)
+{
+	int ret = 0;
+	if(!vga_fb)
+		return 0;
+	mutex_lock(&vga_fb_map_lock);
+	if(atomic_read(&vga_fb_maps))
+		ret = -EBUSY;
+	else
+	{
+		console_lock();
+		fb_set_suspend(vga_fb, FBINFO_STATE_SUSPENDED);
+		vga_fb->screen_base = NULL;
+		console_unlock();
+	}
+	mutex_unlock(&vga_fb_map_lock);
+	return ret;
+}
+
+// the frame buffer was allocated again, maybe somewhere else; fbcon redraws the console
+static void vga_fb_resume(u32* vir, const dma_addr_t phy)
+{
+	if(!vga_fb)
+		return;
+	console_lock();
+	vga_fb_dma = phy;
+	vga_fb->fix.smem_start = phy;
+	vga_fb->screen_base = (char __iomem*)vir;
+	fb_set_suspend(vga_fb, FBINFO_STATE_RUNNING);
+	console_unlock();
+}
+
+#else
+
+static int vga_fb_init(struct device* parent, u32* vir, const dma_addr_t phy, const u32 size) { return 0; }
+static void vga_fb_exit(void) {}
+static int vga_fb_suspend(void) { return 0; }
+static void vga_fb_resume(u32* vir, const dma_addr_t phy) {}
+
+#endif //CONFIG_FB
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_VGAFB_H_
@@ -0,0 +1,72 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_VGAIOCTL_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_VGAIOCTL_H_
+
+#include <linux/ioctl.h>
+#include <linux/types.h>
+
+#define VGA_IOC_MAGIC 'V'
+
+// ioctl(fd, VGA_IOC_BLANK, level), the same levels are written to /sys/class/VGA_drv/vga_dma/blank
+#define VGA_IOC_BLANK _IO(VGA_IOC_MAGIC, 1)
+
+#define VGA_BLANK_OFF 0		// the frame is scanned out
+#define VGA_BLANK_ON 1		// the DMA is stopped, drawing still goes to the frame buffer
+#define VGA_BLANK_DROP 2	// the DMA is stopped and the frame buffer freed, it's allocated again on
+				// unblank (or the next draw) and rebuilt from the shadow mapping, objects and sprites
+
+#define VGA_FONT_MAGIC "VGAF"
+#define VGA_FONT_GLYPHS 256	// indexed by Latin-1 code point, text is decoded from UTF-8
+#define VGA_FONT_MAX_W 8
+#define VGA_FONT_MAX_H 8
+
+// bit-packed font, loaded by ioctl(fd, VGA_IOC_FONT, &font) or the font;load;NAME command.
+// A font file in /lib/firmware is this structure as it is.
+struct vga_font
+{
+	char magic[4];					// VGA_FONT_MAGIC without the terminating zero
+	__u8 height;					// rows of every glyph, 1-8
+	__u8 reserved[3];
+	__u8 width[VGA_FONT_GLYPHS];			// columns of a glyph 1-8, 0 - no glyph
+	__u8 rows[VGA_FONT_GLYPHS][VGA_FONT_MAX_H];	// one byte per row, bit 7 is the leftmost column
+};
+
+#define VGA_IOC_FONT _IOW(VGA_IOC_MAGIC, 2, struct vga_font)
+
+// submission ring: mmap(VGA_RING_MMAP_OFFSET) of an open file maps its struct vga_ring.
+// The client fills sq entries and moves sq_tail, the driver runs them and moves sq_head,
+// every command gets a cq entry with its tag. Indexes only grow, entry is index % VGA_RING_ENTRIES.
+#define VGA_RING_MMAP_OFFSET 0x80000000
+#define VGA_RING_ENTRIES 256		// power of two
+#define VGA_RING_CMD_SIZE 248		// one command line, the newline isn't needed
+
+struct vga_ring_sqe
+{
+	__u32 tag;			// returned in the completion
+	__u16 len;			// bytes of cmd
+	__u16 reserved;
+	char cmd[VGA_RING_CMD_SIZE];
+};
+
+struct vga_ring_cqe
+{
+	__u32 tag;
+	__s32 result;			// 0 or -EINVAL, the kernel log says why
+};
+
+struct vga_ring
+{
+	__u32 sq_head;			// written by the driver
+	__u32 sq_tail;			// written by the client
+	__u32 cq_head;			// written by the client, a full cq stops the driver taking sq entries
+	__u32 cq_tail;			// written by the driver
+	__u32 reserved[12];
+	struct vga_ring_sqe sq[VGA_RING_ENTRIES];
+	struct vga_ring_cqe cq[VGA_RING_ENTRIES];
+};
+
+// doorbell, runs the entries queued so far and returns how many were run
+#define VGA_IOC_RING_ENTER _IO(VGA_IOC_MAGIC, 3)
+// ioctl(fd, VGA_IOC_RING_POLL, 1) - the driver takes new entries after every frame, no doorbell is needed
+#define VGA_IOC_RING_POLL _IO(VGA_IOC_MAGIC, 4)
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_VGAIOCTL_H_
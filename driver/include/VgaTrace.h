@@ -0,0 +1,67 @@
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM vga_dma
+
+#if !defined(MSREAL_VGA_DRIVER_DRIVER_INCLUDE_VGATRACE_H_) || defined(TRACE_HEADER_MULTI_READ)
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_VGATRACE_H_
+
+#include <linux/tracepoint.h>
+
+// a command line was split into fields and its keyword looked up
+TRACE_EVENT(vga_parse,
+	TP_PROTO(const char* command, int fields, int state),
+	TP_ARGS(command, fields, state),
+	TP_STRUCT__entry(
+		__string(command, command)
+		__field(int, fields)
+		__field(int, state)
+	),
+	TP_fast_assign(
+		__assign_str(command, command);
+		__entry->fields = fields;
+		__entry->state = state;
+	),
+	TP_printk("%s fields=%d state=%d", __get_str(command), __entry->fields, __entry->state)
+);
+
+// the command was drawn (or queued in commit mode), ns counts from the start of parsing
+TRACE_EVENT(vga_draw,
+	TP_PROTO(int state, u64 ns, int ret),
+	TP_ARGS(state, ns, ret),
+	TP_STRUCT__entry(
+		__field(int, state)
+		__field(u64, ns)
+		__field(int, ret)
+	),
+	TP_fast_assign(
+		__entry->state = state;
+		__entry->ns = ns;
+		__entry->ret = ret;
+	),
+	TP_printk("state=%d ns=%llu ret=%d", __entry->state, __entry->ns, __entry->ret)
+);
+
+// committed batches were drawn
+TRACE_EVENT(vga_commit,
+	TP_PROTO(unsigned int commands, unsigned long coalesced, u64 ns),
+	TP_ARGS(commands, coalesced, ns),
+	TP_STRUCT__entry(
+		__field(unsigned int, commands)
+		__field(unsigned long, coalesced)
+		__field(u64, ns)
+	),
+	TP_fast_assign(
+		__entry->commands = commands;
+		__entry->coalesced = coalesced;
+		__entry->ns = ns;
+	),
+	TP_printk("commands=%u coalesced=%lu ns=%llu", __entry->commands, __entry->coalesced, __entry->ns)
+);
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_VGATRACE_H_
+
+// define_trace.h includes this file again from the driver directory (-I$(src) in the Makefile)
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH include
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE VgaTrace
+#include <trace/define_trace.h>
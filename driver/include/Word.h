@@ -3,11 +3,11 @@
 
 #include "Point.h"
 #include "utils.h"
+#include "VgaIoctl.h"
 
-#define BIG_FONT_W 10
-#define BIG_FONT_H 14
-#define SMALL_FONT_W 5
-#define SMALL_FONT_H 7
+// big text doubles the glyphs of the font
+#define BIG_FONT_W (2*VGA_FONT_MAX_W)
+#define BIG_FONT_H (2*VGA_FONT_MAX_H)
 
 static struct Word
 {
@@ -15,6 +15,8 @@ static struct Word
 	bool big_font;
     	struct Point pt;
 	unsigned long long char_color, bckg_color;
+	u8 char_alpha, bckg_alpha; // bckg_alpha 0 - transparent background
+	bool anti_alias;
 };
 
 #endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_WORD_H_
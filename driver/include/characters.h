@@ -0,0 +1,234 @@
+#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_CHARACTERS_H_
+#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_CHARACTERS_H_
+
+#include "VgaIoctl.h"
+
+// built-in 7 row font: printable ASCII and Latin-1. Letters are 5 columns wide, accented
+// capitals give up a row to the accent, ';' separates the fields of a command so it has no glyph.
+static const struct vga_font font_builtin =
+{
+	.magic = {'V', 'G', 'A', 'F'},
+	.height = 7,
+	.width =
+	{
+		[' '] = 5, ['!'] = 5, ['"'] = 3, ['#'] = 5, ['$'] = 5, ['%'] = 5, ['&'] = 5, ['\''] = 1,
+		['('] = 3, [')'] = 3, ['*'] = 5, ['+'] = 5, [','] = 5, ['-'] = 3, ['.'] = 5, ['/'] = 5,
+		['0'] = 5, ['1'] = 5, ['2'] = 5, ['3'] = 5, ['4'] = 5, ['5'] = 5, ['6'] = 5, ['7'] = 5,
+		['8'] = 5, ['9'] = 5, [':'] = 1, ['<'] = 4, ['='] = 4, ['>'] = 4, ['?'] = 5, ['@'] = 5,
+		['A'] = 5, ['B'] = 5, ['C'] = 5, ['D'] = 5, ['E'] = 5, ['F'] = 5, ['G'] = 5, ['H'] = 5,
+		['I'] = 5, ['J'] = 5, ['K'] = 5, ['L'] = 5, ['M'] = 5, ['N'] = 5, ['O'] = 5, ['P'] = 5,
+		['Q'] = 5, ['R'] = 5, ['S'] = 5, ['T'] = 5, ['U'] = 5, ['V'] = 5, ['W'] = 5, ['X'] = 5,
+		['Y'] = 5, ['Z'] = 5, ['['] = 3, ['\\'] = 5, [']'] = 3, ['^'] = 5, ['_'] = 5, ['`'] = 2,
+		['a'] = 5, ['b'] = 5, ['c'] = 5, ['d'] = 5, ['e'] = 5, ['f'] = 5, ['g'] = 5, ['h'] = 5,
+		['i'] = 5, ['j'] = 5, ['k'] = 5, ['l'] = 5, ['m'] = 5, ['n'] = 5, ['o'] = 5, ['p'] = 5,
+		['q'] = 5, ['r'] = 5, ['s'] = 5, ['t'] = 5, ['u'] = 5, ['v'] = 5, ['w'] = 5, ['x'] = 5,
+		['y'] = 5, ['z'] = 5, ['{'] = 4, ['|'] = 1, ['}'] = 4, ['~'] = 5, [0xa0] = 5, [0xa1] = 5,
+		[0xa2] = 5, [0xa3] = 5, [0xa4] = 5, [0xa5] = 5, [0xa6] = 1, [0xa7] = 5, [0xa8] = 3, [0xa9] = 5,
+		[0xaa] = 5, [0xab] = 5, [0xac] = 5, [0xad] = 3, [0xae] = 5, [0xaf] = 5, [0xb0] = 3, [0xb1] = 5,
+		[0xb2] = 3, [0xb3] = 3, [0xb4] = 2, [0xb5] = 5, [0xb6] = 5, [0xb7] = 1, [0xb8] = 2, [0xb9] = 3,
+		[0xba] = 5, [0xbb] = 5, [0xbc] = 5, [0xbd] = 5, [0xbe] = 5, [0xbf] = 5, [0xc0] = 5, [0xc1] = 5,
+		[0xc2] = 5, [0xc3] = 5, [0xc4] = 5, [0xc5] = 5, [0xc6] = 5, [0xc7] = 5, [0xc8] = 5, [0xc9] = 5,
+		[0xca] = 5, [0xcb] = 5, [0xcc] = 5, [0xcd] = 5, [0xce] = 5, [0xcf] = 5, [0xd0] = 5, [0xd1] = 5,
+		[0xd2] = 5, [0xd3] = 5, [0xd4] = 5, [0xd5] = 5, [0xd6] = 5, [0xd7] = 5, [0xd8] = 5, [0xd9] = 5,
+		[0xda] = 5, [0xdb] = 5, [0xdc] = 5, [0xdd] = 5, [0xde] = 5, [0xdf] = 5, [0xe0] = 5, [0xe1] = 5,
+		[0xe2] = 5, [0xe3] = 5, [0xe4] = 5, [0xe5] = 5, [0xe6] = 5, [0xe7] = 5, [0xe8] = 5, [0xe9] = 5,
+		[0xea] = 5, [0xeb] = 5, [0xec] = 5, [0xed] = 5, [0xee] = 5, [0xef] = 5, [0xf0] = 5, [0xf1] = 5,
+		[0xf2] = 5, [0xf3] = 5, [0xf4] = 5, [0xf5] = 5, [0xf6] = 5, [0xf7] = 5, [0xf8] = 5, [0xf9] = 5,
+		[0xfa] = 5, [0xfb] = 5, [0xfc] = 5, [0xfd] = 5, [0xfe] = 5, [0xff] = 5,
+	},
+	.rows =
+	{
+		[' '] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+		['!'] = {0x20, 0x20, 0x20, 0x20, 0x20, 0x00, 0x20, 0x00},
+		['"'] = {0xa0, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+		['#'] = {0x50, 0x50, 0xf8, 0x50, 0xf8, 0x50, 0x50, 0x00},
+		['$'] = {0x20, 0x78, 0xa0, 0x70, 0x28, 0xf0, 0x20, 0x00},
+		['%'] = {0xc8, 0xc8, 0x10, 0x20, 0x40, 0x98, 0x98, 0x00},
+		['&'] = {0x60, 0x90, 0xa0, 0x40, 0xa8, 0x90, 0x68, 0x00},
+		['\''] = {0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+		['('] = {0x20, 0x40, 0x80, 0x80, 0x80, 0x40, 0x20, 0x00},
+		[')'] = {0x80, 0x40, 0x20, 0x20, 0x20, 0x40, 0x80, 0x00},
+		['*'] = {0x00, 0xa8, 0x70, 0xf8, 0x70, 0xa8, 0x00, 0x00},
+		['+'] = {0x00, 0x00, 0x20, 0x20, 0xf8, 0x20, 0x20, 0x00},
+		[','] = {0x00, 0x00, 0x00, 0x00, 0x60, 0x20, 0x20, 0x00},
+		['-'] = {0x00, 0x00, 0x00, 0xe0, 0x00, 0x00, 0x00, 0x00},
+		['.'] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00},
+		['/'] = {0x08, 0x08, 0x10, 0x20, 0x40, 0x80, 0x80, 0x00},
+		['0'] = {0x70, 0x88, 0x98, 0xa8, 0xc8, 0x88, 0x70, 0x00},
+		['1'] = {0x20, 0x60, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00},
+		['2'] = {0x70, 0x88, 0x08, 0x10, 0x20, 0x40, 0xf8, 0x00},
+		['3'] = {0x70, 0x88, 0x08, 0x30, 0x08, 0x88, 0x70, 0x00},
+		['4'] = {0x10, 0x30, 0x50, 0x90, 0xf8, 0x10, 0x10, 0x00},
+		['5'] = {0xf8, 0x80, 0xf0, 0x08, 0x08, 0x88, 0x70, 0x00},
+		['6'] = {0x70, 0x80, 0x80, 0xf0, 0x88, 0x88, 0x70, 0x00},
+		['7'] = {0xf8, 0x08, 0x10, 0x20, 0x20, 0x20, 0x20, 0x00},
+		['8'] = {0x70, 0x88, 0x88, 0x70, 0x88, 0x88, 0x70, 0x00},
+		['9'] = {0x70, 0x88, 0x88, 0x78, 0x08, 0x08, 0x70, 0x00},
+		[':'] = {0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x80, 0x00},
+		['<'] = {0x00, 0x10, 0x20, 0x40, 0x80, 0x40, 0x20, 0x00},
+		['='] = {0x00, 0x00, 0xf0, 0x00, 0xf0, 0x00, 0x00, 0x00},
+		['>'] = {0x00, 0x80, 0x40, 0x20, 0x10, 0x20, 0x40, 0x00},
+		['?'] = {0x70, 0x10, 0x70, 0x40, 0x70, 0x00, 0x20, 0x00},
+		['@'] = {0x70, 0x88, 0xb8, 0xa8, 0xb8, 0x80, 0x70, 0x00},
+		['A'] = {0x70, 0xd8, 0x88, 0xf8, 0x88, 0x88, 0x88, 0x00},
+		['B'] = {0xf0, 0x98, 0xb0, 0xe0, 0xb0, 0x98, 0xf0, 0x00},
+		['C'] = {0xf8, 0x98, 0x80, 0x80, 0x80, 0x98, 0xf8, 0x00},
+		['D'] = {0xf0, 0x98, 0x88, 0x88, 0x88, 0x98, 0xf0, 0x00},
+		['E'] = {0xf8, 0x88, 0x80, 0xf8, 0x80, 0x88, 0xf8, 0x00},
+		['F'] = {0xf8, 0x88, 0x80, 0xf8, 0x80, 0x80, 0x80, 0x00},
+		['G'] = {0x78, 0xc8, 0x80, 0xb8, 0xa8, 0xc8, 0x78, 0x00},
+		['H'] = {0xd8, 0x88, 0x88, 0xf8, 0x88, 0x88, 0xd8, 0x00},
+		['I'] = {0x70, 0x20, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00},
+		['J'] = {0xf8, 0x88, 0x08, 0x08, 0xc8, 0xc8, 0xf8, 0x00},
+		['K'] = {0x88, 0x98, 0xa0, 0xe0, 0xa0, 0x98, 0x88, 0x00},
+		['L'] = {0x80, 0x80, 0x80, 0x80, 0x80, 0x88, 0xf8, 0x00},
+		['M'] = {0x88, 0xd8, 0xa8, 0xa8, 0x88, 0x88, 0x88, 0x00},
+		['N'] = {0x88, 0xc8, 0xa8, 0x98, 0x88, 0x88, 0x88, 0x00},
+		['O'] = {0x70, 0xd8, 0x88, 0x88, 0x88, 0xd8, 0x70, 0x00},
+		['P'] = {0xf0, 0x88, 0x90, 0xe0, 0x80, 0x80, 0x80, 0x00},
+		['Q'] = {0x60, 0x90, 0x90, 0x90, 0x90, 0x70, 0x08, 0x00},
+		['R'] = {0xf0, 0x88, 0x90, 0xe0, 0xa0, 0x90, 0x88, 0x00},
+		['S'] = {0xf8, 0x88, 0x80, 0xf8, 0x08, 0x88, 0xf8, 0x00},
+		['T'] = {0xf8, 0xa8, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00},
+		['U'] = {0x88, 0x88, 0x88, 0x88, 0x88, 0xd8, 0x70, 0x00},
+		['V'] = {0x88, 0x88, 0xd8, 0x70, 0x70, 0x20, 0x20, 0x00},
+		['W'] = {0xa8, 0xa8, 0xa8, 0xf8, 0x50, 0x50, 0x50, 0x00},
+		['X'] = {0x88, 0x50, 0x70, 0x20, 0x70, 0x50, 0x88, 0x00},
+		['Y'] = {0x88, 0xd8, 0x50, 0x20, 0x20, 0x20, 0x20, 0x00},
+		['Z'] = {0xf8, 0x10, 0x20, 0x60, 0xc0, 0xf8, 0xf8, 0x00},
+		['['] = {0xe0, 0x80, 0x80, 0x80, 0x80, 0x80, 0xe0, 0x00},
+		['\\'] = {0x80, 0x80, 0x40, 0x20, 0x10, 0x08, 0x08, 0x00},
+		[']'] = {0xe0, 0x20, 0x20, 0x20, 0x20, 0x20, 0xe0, 0x00},
+		['^'] = {0x20, 0x50, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00},
+		['_'] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf8, 0x00},
+		['`'] = {0x80, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+		['a'] = {0x00, 0x70, 0x10, 0x70, 0x50, 0x50, 0x78, 0x00},
+		['b'] = {0x00, 0x40, 0x40, 0x40, 0x70, 0x50, 0x70, 0x00},
+		['c'] = {0x00, 0x70, 0x50, 0x40, 0x40, 0x50, 0x70, 0x00},
+		['d'] = {0x00, 0x10, 0x10, 0x10, 0x70, 0x50, 0x70, 0x00},
+		['e'] = {0x00, 0x70, 0x50, 0x70, 0x40, 0x50, 0x70, 0x00},
+		['f'] = {0x00, 0x38, 0x20, 0xf8, 0x20, 0x20, 0x20, 0x00},
+		['g'] = {0x00, 0x70, 0x50, 0x70, 0x10, 0x50, 0x70, 0x00},
+		['h'] = {0x00, 0x40, 0x40, 0x40, 0x70, 0x50, 0x50, 0x00},
+		['i'] = {0x00, 0x20, 0x00, 0x20, 0x20, 0x20, 0x20, 0x00},
+		['j'] = {0x20, 0x00, 0x70, 0x10, 0x10, 0x50, 0x70, 0x00},
+		['k'] = {0x40, 0x40, 0x50, 0x60, 0x60, 0x50, 0x50, 0x00},
+		['l'] = {0x00, 0x20, 0x20, 0x20, 0x20, 0x20, 0x30, 0x00},
+		['m'] = {0x00, 0x80, 0xf8, 0xa8, 0xa8, 0xa8, 0xa8, 0x00},
+		['n'] = {0x00, 0x40, 0x70, 0x50, 0x50, 0x50, 0x50, 0x00},
+		['o'] = {0x00, 0x20, 0x50, 0x50, 0x50, 0x50, 0x20, 0x00},
+		['p'] = {0x00, 0x30, 0x28, 0x30, 0x20, 0x20, 0x20, 0x00},
+		['q'] = {0x00, 0x70, 0x50, 0x70, 0x10, 0x10, 0x10, 0x00},
+		['r'] = {0x00, 0x40, 0x70, 0x50, 0x40, 0x40, 0x40, 0x00},
+		['s'] = {0x00, 0x00, 0x70, 0x40, 0x70, 0x10, 0x70, 0x00},
+		['t'] = {0x00, 0x20, 0x70, 0x20, 0x20, 0x28, 0x38, 0x00},
+		['u'] = {0x00, 0x50, 0x50, 0x50, 0x50, 0x50, 0x70, 0x00},
+		['v'] = {0x00, 0x00, 0x50, 0x50, 0x50, 0x70, 0x20, 0x00},
+		['w'] = {0x00, 0x00, 0x88, 0xa8, 0xa8, 0xe8, 0x50, 0x00},
+		['x'] = {0x00, 0x00, 0x00, 0x50, 0x20, 0x20, 0x50, 0x00},
+		['y'] = {0x00, 0x00, 0x50, 0x30, 0x10, 0x10, 0x70, 0x00},
+		['z'] = {0x00, 0x00, 0x70, 0x10, 0x20, 0x40, 0x70, 0x00},
+		['{'] = {0x30, 0x40, 0x40, 0x80, 0x40, 0x40, 0x30, 0x00},
+		['|'] = {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00},
+		['}'] = {0xc0, 0x20, 0x20, 0x10, 0x20, 0x20, 0xc0, 0x00},
+		['~'] = {0x00, 0x00, 0x40, 0xa8, 0x10, 0x00, 0x00, 0x00},
+		[0xa0] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+		[0xa1] = {0x20, 0x00, 0x20, 0x20, 0x20, 0x20, 0x20, 0x00},
+		[0xa2] = {0x20, 0x70, 0xa0, 0xa0, 0xa0, 0x70, 0x20, 0x00},
+		[0xa3] = {0x30, 0x48, 0x40, 0xe0, 0x40, 0x48, 0xf8, 0x00},
+		[0xa4] = {0x00, 0x88, 0x70, 0x50, 0x70, 0x88, 0x00, 0x00},
+		[0xa5] = {0x88, 0x50, 0x20, 0xf8, 0x20, 0xf8, 0x20, 0x00},
+		[0xa6] = {0x80, 0x80, 0x80, 0x00, 0x80, 0x80, 0x80, 0x00},
+		[0xa7] = {0x30, 0x40, 0x20, 0x50, 0x20, 0x10, 0x60, 0x00},
+		[0xa8] = {0xa0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+		[0xa9] = {0xf8, 0x88, 0xb8, 0xa8, 0xb8, 0x88, 0xf8, 0x00},
+		[0xaa] = {0x70, 0x10, 0x78, 0x50, 0x78, 0x00, 0x78, 0x00},
+		[0xab] = {0x00, 0x00, 0x28, 0x50, 0xa0, 0x50, 0x28, 0x00},
+		[0xac] = {0x00, 0x00, 0x00, 0xf8, 0x08, 0x00, 0x00, 0x00},
+		[0xad] = {0x00, 0x00, 0x00, 0xe0, 0x00, 0x00, 0x00, 0x00},
+		[0xae] = {0xf8, 0x98, 0xa8, 0x98, 0xa8, 0x88, 0xf8, 0x00},
+		[0xaf] = {0xf8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+		[0xb0] = {0x40, 0xa0, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00},
+		[0xb1] = {0x00, 0x20, 0x20, 0xf8, 0x20, 0x20, 0xf8, 0x00},
+		[0xb2] = {0xc0, 0x20, 0x40, 0xe0, 0x00, 0x00, 0x00, 0x00},
+		[0xb3] = {0xe0, 0x60, 0x20, 0xe0, 0x00, 0x00, 0x00, 0x00},
+		[0xb4] = {0x40, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+		[0xb5] = {0x00, 0x00, 0x90, 0x90, 0x90, 0xe8, 0x80, 0x00},
+		[0xb6] = {0x78, 0xe8, 0xe8, 0x68, 0x28, 0x28, 0x28, 0x00},
+		[0xb7] = {0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00},
+		[0xb8] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x80, 0x00},
+		[0xb9] = {0x40, 0xc0, 0x40, 0xe0, 0x00, 0x00, 0x00, 0x00},
+		[0xba] = {0x20, 0x50, 0x50, 0x20, 0x00, 0x70, 0x00, 0x00},
+		[0xbb] = {0x00, 0x00, 0xa0, 0x50, 0x28, 0x50, 0xa0, 0x00},
+		[0xbc] = {0x80, 0x90, 0xa0, 0x20, 0x50, 0xb8, 0x10, 0x00},
+		[0xbd] = {0x80, 0x90, 0xa0, 0x30, 0x48, 0x90, 0x18, 0x00},
+		[0xbe] = {0xc0, 0x50, 0xc0, 0x20, 0x50, 0xb8, 0x10, 0x00},
+		[0xbf] = {0x20, 0x00, 0x70, 0x10, 0x70, 0x40, 0x70, 0x00},
+		[0xc0] = {0x40, 0x70, 0xd8, 0x88, 0xf8, 0x88, 0x88, 0x00},
+		[0xc1] = {0x10, 0x70, 0xd8, 0x88, 0xf8, 0x88, 0x88, 0x00},
+		[0xc2] = {0x20, 0x70, 0xd8, 0x88, 0xf8, 0x88, 0x88, 0x00},
+		[0xc3] = {0x68, 0x90, 0x70, 0x88, 0xf8, 0x88, 0x88, 0x00},
+		[0xc4] = {0x50, 0x70, 0xd8, 0x88, 0xf8, 0x88, 0x88, 0x00},
+		[0xc5] = {0x20, 0x50, 0x70, 0x88, 0xf8, 0x88, 0x88, 0x00},
+		[0xc6] = {0x78, 0xa0, 0xa0, 0xf8, 0xa0, 0xa0, 0xb8, 0x00},
+		[0xc7] = {0xf8, 0x98, 0x80, 0x98, 0xf8, 0x20, 0x40, 0x00},
+		[0xc8] = {0x40, 0xf8, 0x80, 0xf8, 0x80, 0x88, 0xf8, 0x00},
+		[0xc9] = {0x10, 0xf8, 0x80, 0xf8, 0x80, 0x88, 0xf8, 0x00},
+		[0xca] = {0x20, 0xf8, 0x80, 0xf8, 0x80, 0x88, 0xf8, 0x00},
+		[0xcb] = {0x50, 0xf8, 0x80, 0xf8, 0x80, 0x88, 0xf8, 0x00},
+		[0xcc] = {0x40, 0x70, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00},
+		[0xcd] = {0x10, 0x70, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00},
+		[0xce] = {0x20, 0x70, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00},
+		[0xcf] = {0x50, 0x70, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00},
+		[0xd0] = {0xf0, 0x98, 0x88, 0xe8, 0x88, 0x98, 0xf0, 0x00},
+		[0xd1] = {0x70, 0x88, 0xc8, 0xa8, 0x98, 0x88, 0x88, 0x00},
+		[0xd2] = {0x40, 0x70, 0xd8, 0x88, 0x88, 0xd8, 0x70, 0x00},
+		[0xd3] = {0x10, 0x70, 0xd8, 0x88, 0x88, 0xd8, 0x70, 0x00},
+		[0xd4] = {0x20, 0x70, 0xd8, 0x88, 0x88, 0xd8, 0x70, 0x00},
+		[0xd5] = {0x68, 0x90, 0x70, 0x88, 0x88, 0x88, 0x70, 0x00},
+		[0xd6] = {0x50, 0x70, 0xd8, 0x88, 0x88, 0xd8, 0x70, 0x00},
+		[0xd7] = {0x00, 0x00, 0x88, 0x50, 0x20, 0x50, 0x88, 0x00},
+		[0xd8] = {0x78, 0xd8, 0x98, 0xa8, 0xc8, 0xd8, 0xf0, 0x00},
+		[0xd9] = {0x40, 0x88, 0x88, 0x88, 0x88, 0xd8, 0x70, 0x00},
+		[0xda] = {0x10, 0x88, 0x88, 0x88, 0x88, 0xd8, 0x70, 0x00},
+		[0xdb] = {0x20, 0x88, 0x88, 0x88, 0x88, 0xd8, 0x70, 0x00},
+		[0xdc] = {0x50, 0x88, 0x88, 0x88, 0x88, 0xd8, 0x70, 0x00},
+		[0xdd] = {0x10, 0x88, 0xd8, 0x50, 0x20, 0x20, 0x20, 0x00},
+		[0xde] = {0x80, 0xf0, 0x88, 0x88, 0xf0, 0x80, 0x80, 0x00},
+		[0xdf] = {0x60, 0x90, 0x90, 0xa0, 0x90, 0x90, 0xa0, 0x00},
+		[0xe0] = {0x40, 0x70, 0x10, 0x70, 0x50, 0x50, 0x78, 0x00},
+		[0xe1] = {0x10, 0x70, 0x10, 0x70, 0x50, 0x50, 0x78, 0x00},
+		[0xe2] = {0x20, 0x70, 0x10, 0x70, 0x50, 0x50, 0x78, 0x00},
+		[0xe3] = {0x70, 0x70, 0x10, 0x70, 0x50, 0x50, 0x78, 0x00},
+		[0xe4] = {0x50, 0x70, 0x10, 0x70, 0x50, 0x50, 0x78, 0x00},
+		[0xe5] = {0x20, 0x50, 0x20, 0x78, 0x50, 0x50, 0x78, 0x00},
+		[0xe6] = {0x00, 0x00, 0xf0, 0x28, 0xf8, 0xa0, 0xf8, 0x00},
+		[0xe7] = {0x00, 0x70, 0x50, 0x40, 0x50, 0x70, 0x30, 0x00},
+		[0xe8] = {0x40, 0x70, 0x50, 0x70, 0x40, 0x50, 0x70, 0x00},
+		[0xe9] = {0x10, 0x70, 0x50, 0x70, 0x40, 0x50, 0x70, 0x00},
+		[0xea] = {0x20, 0x70, 0x50, 0x70, 0x40, 0x50, 0x70, 0x00},
+		[0xeb] = {0x50, 0x70, 0x50, 0x70, 0x40, 0x50, 0x70, 0x00},
+		[0xec] = {0x40, 0x00, 0x00, 0x20, 0x20, 0x20, 0x20, 0x00},
+		[0xed] = {0x10, 0x00, 0x00, 0x20, 0x20, 0x20, 0x20, 0x00},
+		[0xee] = {0x20, 0x00, 0x00, 0x20, 0x20, 0x20, 0x20, 0x00},
+		[0xef] = {0x50, 0x00, 0x00, 0x20, 0x20, 0x20, 0x20, 0x00},
+		[0xf0] = {0x50, 0x20, 0x50, 0x70, 0x50, 0x50, 0x70, 0x00},
+		[0xf1] = {0x70, 0x40, 0x70, 0x50, 0x50, 0x50, 0x50, 0x00},
+		[0xf2] = {0x40, 0x20, 0x50, 0x50, 0x50, 0x50, 0x20, 0x00},
+		[0xf3] = {0x10, 0x20, 0x50, 0x50, 0x50, 0x50, 0x20, 0x00},
+		[0xf4] = {0x20, 0x20, 0x50, 0x50, 0x50, 0x50, 0x20, 0x00},
+		[0xf5] = {0x70, 0x20, 0x50, 0x50, 0x50, 0x50, 0x20, 0x00},
+		[0xf6] = {0x50, 0x20, 0x50, 0x50, 0x50, 0x50, 0x20, 0x00},
+		[0xf7] = {0x00, 0x20, 0x00, 0xf8, 0x00, 0x20, 0x00, 0x00},
+		[0xf8] = {0x00, 0x08, 0x30, 0x50, 0x50, 0x60, 0x80, 0x00},
+		[0xf9] = {0x40, 0x50, 0x50, 0x50, 0x50, 0x50, 0x70, 0x00},
+		[0xfa] = {0x10, 0x50, 0x50, 0x50, 0x50, 0x50, 0x70, 0x00},
+		[0xfb] = {0x20, 0x50, 0x50, 0x50, 0x50, 0x50, 0x70, 0x00},
+		[0xfc] = {0x50, 0x50, 0x50, 0x50, 0x50, 0x50, 0x70, 0x00},
+		[0xfd] = {0x10, 0x00, 0x50, 0x30, 0x10, 0x10, 0x70, 0x00},
+		[0xfe] = {0x00, 0x40, 0x70, 0x50, 0x70, 0x40, 0x40, 0x00},
+		[0xff] = {0x50, 0x00, 0x50, 0x30, 0x10, 0x10, 0x70, 0x00},
+	},
+};
+
+#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_CHARACTERS_H_
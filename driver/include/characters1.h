@@ -1,349 +0,0 @@
-#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_CHARACTERS1_H_
-#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_CHARACTERS1_H_
-
-static const bool A[7][5] =
-{
-	{1, 0, 0, 0, 1},
-	{0, 0, 1, 0, 0},
-	{0, 1, 1, 1, 0},
-	{0, 0, 0, 0, 0},		    
-	{0, 1, 1, 1, 0},		        
-	{0, 1, 1, 1, 0},			    
-	{0, 1, 1, 1, 0}
-};
-
-static const bool B[7][5] =
-{
-	{0, 0, 0, 0, 1},
-	{0, 1, 1, 0, 0},
-	{0, 1, 0, 0, 1},
-	{0, 0, 0, 1, 1},
-	{0, 1, 0, 0, 1},
-	{0, 1, 1, 0, 0},
-	{0, 0, 0, 0, 1}
-};
-
-static const bool C[7][5] =
-{
-	{0, 0, 0, 0, 0},
-	{0, 1, 1, 0, 0},
-	{0, 1, 1, 1, 1},
-	{0, 1, 1, 1, 1},
-	{0, 1, 1, 1, 1},
-	{0, 1, 1, 0, 0},
-	{0, 0, 0, 0, 0},
-};
-
-
-static const bool D[7][5] =
-{
-	{0, 0, 0, 0, 1},
-	{0, 1, 1, 0, 0},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 0, 0},
-	{0, 0, 0, 0, 1},
-};
-
-
-static const bool E[7][5] =
-{
-	{0, 0, 0, 0, 0},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 1, 1},
-	{0, 0, 0, 0, 0},
-	{0, 1, 1, 1, 1},
-	{0, 1, 1, 1, 0},
-	{0, 0, 0, 0, 0},
-};
-
-
-static const bool F[7][5] =
-{
-	{0, 0, 0, 0, 0},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 1, 1},
-	{0, 0, 0, 0, 0},
-	{0, 1, 1, 1, 1},
-	{0, 1, 1, 1, 1},
-	{0, 1, 1, 1, 1},
-};
-
-
-static const bool G[7][5] =
-{
-	{1, 0, 0, 0, 0},
-	{0, 0, 1, 1, 0},
-	{0, 1, 1, 1, 1},
-	{0, 1, 0, 0, 0},
-	{0, 1, 0, 1, 0},
-	{0, 0, 1, 1, 0},
-	{1, 0, 0, 0, 0},
-};
-
-static const bool H[7][5] =
-{
-	{0, 0, 1, 0, 0},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 1, 0},
-	{0, 0, 0, 0, 0},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 1, 0},
-	{0, 0, 1, 0, 0},
-};
-
-static const bool I[7][5] =
-{
-	{1, 0, 0, 0, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 0, 0, 0, 1},
-};
-
-static const bool J[7][5] =
-{
-	{0, 0, 0, 0, 0},
-	{0, 1, 1, 1, 0},
-	{1, 1, 1, 1, 0},
-	{1, 1, 1, 1, 0},
-	{0, 0, 1, 1, 0},
-	{0, 0, 1, 1, 0},
-	{0, 0, 0, 0, 0},
-};
-
-static const bool K[7][5] =
-{
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 0, 0},
-	{0, 1, 0, 1, 1},
-	{0, 0, 0, 1, 1},
-	{0, 1, 0, 1, 1},
-	{0, 1, 1, 0, 0},
-	{0, 1, 1, 1, 0},
-};
-
-static const bool L[7][5] =
-{
-	{0, 1, 1, 1, 1},
-	{0, 1, 1, 1, 1},
-	{0, 1, 1, 1, 1},
-	{0, 1, 1, 1, 1},
-	{0, 1, 1, 1, 1},
-	{0, 1, 1, 1, 0},
-	{0, 0, 0, 0, 0},
-};
-
-static const bool M[7][5] =
-{
-	{0, 1, 1, 1, 0},
-	{0, 0, 1, 0, 0},
-	{0, 1, 0, 1, 0},
-	{0, 1, 0, 1, 0},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 1, 0},
-};
-
-static const bool N[7][5] =
-{
-	{0, 1, 1, 1, 0},
-	{0, 0, 1, 1, 0},
-	{0, 1, 0, 1, 0},
-	{0, 1, 1, 0, 0},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 1, 0},
-};
-
-static const bool O[7][5] =
-{
-	{1, 0, 0, 0, 1},
-	{0, 0, 1, 0, 0},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 1, 0},
-	{0, 0, 1, 0, 0},
-	{1, 0, 0, 0, 1},
-};
-
-static const bool P[7][5] =
-{
-	{0, 0, 0, 0, 1},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 0, 1},
-	{0, 0, 0, 1, 1},
-	{0, 1, 1, 1, 1},
-	{0, 1, 1, 1, 1},
-	{0, 1, 1, 1, 1},
-};
-
-static const bool R[7][5] =
-{
-	{0, 0, 0, 0, 1},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 0, 1},
-	{0, 0, 0, 1, 1},
-	{0, 1, 0, 1, 1},
-	{0, 1, 1, 0, 1},
-	{0, 1, 1, 1, 0},
-};
-
-static const bool S[7][5] =
-{
-	{0, 0, 0, 0, 0},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 1, 1},
-	{0, 0, 0, 0, 0},
-	{1, 1, 1, 1, 0},
-	{0, 1, 1, 1, 0},
-	{0, 0, 0, 0, 0},
-};
-
-static const bool T[7][5] =
-{
-	{0, 0, 0, 0, 0},
-	{0, 1, 0, 1, 0},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 0, 0, 0, 1},
-};
-
-static const bool Q[7][5] =
-{
-	{1, 0, 0, 1, 1},
-	{0, 1, 1, 0, 1},
-	{0, 1, 1, 0, 1},
-	{0, 1, 1, 0, 1},
-	{0, 1, 1, 0, 1},
-	{1, 0, 0, 0, 1},
-	{1, 1, 1, 1, 0},
-};
-
-static const bool U[7][5] =
-{
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 1, 0},
-	{0, 0, 1, 0, 0},
-	{1, 0, 0, 0, 1},
-};
-
-static const bool V[7][5] =
-{
-	{0, 1, 1, 1, 0},
-	{0, 1, 1, 1, 0},
-	{0, 0, 1, 0, 0},
-	{1, 0, 0, 0, 1},
-	{1, 0, 0, 0, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-};
-
-static const bool W[7][5] =
-{
-	{0, 1, 0, 1, 0},
-	{0, 1, 0, 1, 0},
-	{0, 1, 0, 1, 0},
-	{0, 0, 0, 0, 0},
-	{1, 0, 1, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 1, 0, 1},
-};
-
-static const bool X[7][5] =
-{
-	{0, 1, 1, 1, 0},
-	{1, 0, 1, 0, 1},
-	{1, 0, 0, 0, 1},
-	{1, 1, 0, 1, 1},
-	{1, 0, 0, 0, 1},
-	{1, 0, 1, 0, 1},
-	{0, 1, 1, 1, 0},
-};
-
-static const bool Y[7][5] =
-{
-	{0, 1, 1, 1, 0},
-	{0, 0, 1, 0, 0},
-	{1, 0, 1, 0, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-};
-
-static const bool Z[7][5] =
-{
-	{0, 0, 0, 0, 0},
-	{1, 1, 1, 0, 1},
-	{1, 1, 0, 1, 1},
-	{1, 0, 0, 1, 1},
-	{0, 0, 1, 1, 1},
-	{0, 0, 0, 0, 0},
-	{0, 0, 0, 0, 0},
-};
-
-static const bool space[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-};
-
-static const bool exclamation[7][5] =
-{
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 1, 0, 1, 1},
-};
-
-static const bool comma[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 0, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-};
-
-static const bool dot[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 1, 0, 1, 1},
-};
-
-static const bool questionnaire[7][5] =
-{
-	{1, 0, 0, 0, 1},
-	{1, 1, 1, 0, 1},
-	{1, 0, 0, 0, 1},
-	{1, 0, 1, 1, 1},
-	{1, 0, 0, 0, 1},
-	{1, 1, 1, 1, 1},
-	{1, 1, 0, 1, 1},
-};
-
-#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_CHARACTERS1_H_
\ No newline at end of file
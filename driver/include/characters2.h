@@ -1,294 +0,0 @@
-#ifndef MSREAL_VGA_DRIVER_DRIVER_INCLUDE_CHARACTERS2_H_
-#define MSREAL_VGA_DRIVER_DRIVER_INCLUDE_CHARACTERS2_H_
-
-static const bool a[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 0, 0, 0, 1},
-	{1, 1, 1, 0, 1},
-	{1, 0, 0, 0, 1},		    
-	{1, 0, 1, 0, 1},		        
-	{1, 0, 1, 0, 1},			    
-	{1, 0, 0, 0, 0}
-};
-
-static const bool b[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 0, 1, 1, 1},
-	{1, 0, 1, 1, 1},
-	{1, 0, 1, 1, 1},
-	{1, 0, 0, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 0, 0, 1}
-};
-
-static const bool c[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 0, 0, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 1, 1, 1},
-	{1, 0, 1, 1, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 0, 0, 1}
-};
-
-
-static const bool d[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 0, 1},
-	{1, 1, 1, 0, 1},
-	{1, 1, 1, 0, 1},
-	{1, 0, 0, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 0, 0, 1}
-};
-
-
-static const bool e[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 0, 0, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 0, 0, 1},
-	{1, 0, 1, 1, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 0, 0, 1}
-};
-
-
-static const bool f[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 1, 0, 0, 0},
-	{1, 1, 0, 1, 1},
-	{0, 0, 0, 0, 0},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1}
-};
-
-
-static const bool g[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 0, 0, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 0, 0, 1},
-	{1, 1, 1, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 0, 0, 1}
-};
-
-static const bool h[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 0, 1, 1, 1},
-	{1, 0, 1, 1, 1},
-	{1, 0, 1, 1, 1},
-	{1, 0, 0, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 1, 0, 1}
-};
-
-static const bool i[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1}
-};
-
-static const bool j[7][5] =
-{
-	{1, 1, 0, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 0, 0, 0, 1},
-	{1, 1, 1, 0, 1},
-	{1, 1, 1, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 0, 0, 1}
-};
-
-static const bool k[7][5] =
-{
-	{1, 0, 1, 1, 1},
-	{1, 0, 1, 1, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 0, 1, 1},
-	{1, 0, 0, 1, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 1, 0, 1}
-};
-
-static const bool l[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 0, 1}
-};
-
-static const bool m[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{0, 1, 1, 1, 1},
-	{0, 0, 0, 0, 0},
-	{0, 1, 0, 1, 0},
-	{0, 1, 0, 1, 0},
-	{0, 1, 0, 1, 0},
-	{0, 1, 0, 1, 0}
-};
-
-static const bool n[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 0, 1, 1, 1},
-	{1, 0, 0, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 1, 0, 1}
-};
-
-static const bool o[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 1, 0, 1, 1}
-};
-
-static const bool p[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 1, 0, 0, 1},
-	{1, 1, 0, 1, 0},
-	{1, 1, 0, 0, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1}
-};
-
-static const bool r[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 0, 1, 1, 1},
-	{1, 0, 0, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 1, 1, 1},
-	{1, 0, 1, 1, 1},
-	{1, 0, 1, 1, 1}
-};
-
-static const bool s[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 0, 0, 0, 1},
-	{1, 0, 1, 1, 1},
-	{1, 0, 0, 0, 1},
-	{1, 1, 1, 0, 1},
-	{1, 0, 0, 0, 1}
-};
-
-static const bool t[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 0, 0, 0, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 0},
-	{1, 1, 0, 0, 0}
-};
-
-static const bool q[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 0, 0, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 0, 0, 1},
-	{1, 1, 1, 0, 1},
-	{1, 1, 1, 0, 1},
-	{1, 1, 1, 0, 1}
-};
-
-static const bool u[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 0, 0, 1}
-};
-
-static const bool v[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 1, 0, 1},
-	{1, 0, 0, 0, 1},
-	{1, 1, 0, 1, 1}
-};
-
-static const bool w[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{0, 1, 1, 1, 0},
-	{0, 1, 0, 1, 0},
-	{0, 1, 0, 1, 0},
-	{0, 0, 0, 1, 0},
-	{1, 0, 1, 0, 1}
-};
-
-static const bool x[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 0, 1, 0, 1},
-	{1, 1, 0, 1, 1},
-	{1, 1, 0, 1, 1},
-	{1, 0, 1, 0, 1}
-};
-
-static const bool y[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 0, 1, 0, 1},
-	{1, 1, 0, 0, 1},
-	{1, 1, 1, 0, 1},
-	{1, 1, 1, 0, 1},
-	{1, 0, 0, 0, 1}
-};
-
-static const bool z[7][5] =
-{
-	{1, 1, 1, 1, 1},
-	{1, 1, 1, 1, 1},
-	{1, 0, 0, 0, 1},
-	{1, 1, 1, 0, 1},
-	{1, 1, 0, 1, 1},
-	{1, 0, 1, 1, 1},
-	{1, 0, 0, 0, 1}
-};
-
-#endif //MSREAL_VGA_DRIVER_DRIVER_INCLUDE_CHARACTERS2_H_
\ No newline at end of file
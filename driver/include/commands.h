@@ -1,9 +1,77 @@
+#include "Raster.h"
 #include "PrintWord.h"
 #include "PrintLine.h"
 #include "PrintRect.h"
 #include "PrintCircle.h"
+#include "PrintPolygon.h"
+#include "PrintPix.h"
+#include "PrintShape.h"
+#include "TileBatch.h"
+#include "PrintSprite.h"
+#include "PrintScene.h"
+#include "DeferredIO.h"
+#include "PrintContext.h"
+#include "PrintImage.h"
+#include "Pan.h"
+#include "Latency.h"
 
-static int assign_params_from_commands(const state_t state, const char(* commands)[BUFF_SIZE])
+static int assign_params_from_commands(const state_t state, const char* const* commands);
+
+#include "PrintCommit.h"
+
+static void commit_font_changed(struct list_head* ops)
+{
+	struct CommitOp* op;
+	list_for_each_entry(op, ops, list)
+		if(!op->line && op->shape.type == state_TEXT)
+			op->shape.box = shape_bbox(&op->shape);
+}
+
+// text boxes follow the font: objects are repainted over their old and new box, text sprites
+// are shown again (cut to the size of a sprite) and queued commit ops are coalesced by the new box.
+// A dropped frame buffer is repainted as a whole when it comes back, only the boxes change then.
+static void font_changed(void)
+{
+	struct SceneObject* obj;
+	struct Sprite *spr, *lifted = NULL;
+	struct GContext* gc;
+
+	list_for_each_entry(obj, &scene_objects, list)
+		if(obj->shape.type == state_TEXT)
+		{
+			const struct Box old = obj->shape.box;
+			obj->shape.box = shape_bbox(&obj->shape);
+			if(tx_vir_buffer)
+				scene_add_damage(box_union(&old, &obj->shape.box));
+		}
+	list_for_each_entry(gc, &gc_files, list)
+		commit_font_changed(&gc->commit_queue);
+	commit_font_changed(&commit_ready);
+
+	list_for_each_entry(spr, &sprites, list)
+		if(spr->shape.type == state_TEXT)
+		{
+			lifted = spr;
+			break;
+		}
+	if(!lifted)
+		return;
+	if(tx_vir_buffer)
+		sprites_lift(lifted);
+	spr = lifted;
+	list_for_each_entry_from(spr, &sprites, list)
+		if(spr->shape.type == state_TEXT)
+		{
+			struct Box* box = &spr->shape.box;
+			*box = shape_bbox(&spr->shape);
+			box->x1 = min(box->x1, box->x0 + SPRITE_MAX_W - 1);
+			box->y1 = min(box->y1, box->y0 + SPRITE_MAX_H - 1);
+		}
+	if(tx_vir_buffer)
+		sprites_drop(&lifted->list);
+}
+
+static int assign_params_from_commands(const state_t state, const char* const* commands)
 {
 	int ret=0;
 	if(state == state_TEXT)
@@ -37,16 +105,97 @@ static int assign_params_from_commands(const state_t state, const char(* command
 	else if(state == state_CIRC)
 	{
 		struct Circle circle;
-		setCircle(&circle, commands);
+		ret = setCircle(&circle, commands);
+		if(ret == -1)
+			return ret;
 		CircleOnScreen(&circle);
 	}
 	else if(state == state_PIX)
 	{
-		unsigned long long pix_color;
-		unsigned int x=strToInt(commands[1]),
-		y = strToInt(commands[2]);
-		ret = kstrtoull((unsigned char*)commands[3],0,&pix_color);
-		tx_vir_buffer[640*y+x] = (u32)pix_color;
+		struct Pix pix;
+		ret = setPix(&pix, commands);
+		if(ret == -1)
+			return ret;
+		PixOnScreen(&pix);
+	}
+	else if(state == state_POLY || state == state_TRI)
+	{
+		struct Polygon poly;
+		ret = (state == state_POLY) ? setPolygon(&poly, commands) : setTriangle(&poly, commands);
+		if(ret == -1)
+			return ret;
+		PolygonOnScreen(&poly);
+	}
+	else if(state == state_OBJ)
+	{
+		ret = scene_command(commands);
+	}
+	else if(state == state_SPR)
+	{
+		ret = sprite_command(commands);
+	}
+	else if(state == state_PAN)
+	{
+		ret = pan_command(commands);
+	}
+	else if(state == state_FONT)
+	{
+		ret = font_command(commands);
+	}
+	return ret;
+}
+
+// line is split in place, commands gets the CMD_FIELDS+1 field pointers,
+// gc is the graphics context of the file the command was written to
+static int exec_command(char* line, const char** commands, struct GContext* gc)
+{
+	const struct Box screen = {0, 0, MAX_W, MAX_H};
+	const u64 start = ktime_get_ns();
+	state_t state = state_IMG;
+	int i, fields, ret;
+	u64 ns;
+
+	// palette and pixel bytes are decoded straight from the line
+	if(!strncmp(line, "img;data;", 9) || !strncmp(line, "IMG;DATA;", 9))
+	{
+		ret = image_data(&gc->image, line + 9);
+		goto out;
+	}
+	if(!strncmp(line, "img;pal;", 8) || !strncmp(line, "IMG;PAL;", 8))
+	{
+		ret = image_palette(&gc->image, line + 8);
+		goto out;
+	}
+
+	fields = parse_buffer(line, commands);
+	for(i=0; i<fields;++i)
+		pr_debug("vga_dma: %d: %s\n", i, commands[i]);
+	state = getState(commands[0]);
+	trace_vga_parse(commands[0], fields, state);
+
+	if(state == state_COMMIT)
+		ret = commit_command(gc, commands);
+	else if(state == state_GC)
+		ret = gc_command(gc, commands);
+	else if(state == state_IMG)
+		ret = image_command(gc, commands);
+	else if(state == state_ERR || gc_expand(gc, state, commands, gc->coords, CMD_FIELDS))
+		ret = -1;
+	else if(gc->commit_mode != commit_OFF)
+		ret = commit_add(gc, state, commands);
+	else if(state == state_OBJ || state == state_SPR || state == state_PAN || state == state_FONT)
+		ret = assign_params_from_commands(state, commands);
+	else if(!list_empty(&sprites))
+		ret = sprites_draw_under(commands, &gc->clip);
+	else
+	{
+		clip = gc->clip;
+		ret = assign_params_from_commands(state, commands);
+		clip = screen;
 	}
+out:
+	ns = ktime_get_ns() - start;
+	latency_add(state, ns);
+	trace_vga_draw(state, ns, ret);
 	return ret;
 }
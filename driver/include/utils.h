@@ -5,56 +5,206 @@
 #define MAX_H 479
 
 #define BUFF_SIZE 50
+#define POLY_MAX_POINTS 32
+#define POLY_FIELDS (2 + 2*POLY_MAX_POINTS)
+#define CMD_FIELDS (3 + POLY_FIELDS) // room for the obj;OP;ID; prefix
 
 typedef int state_t;
-enum {state_TEXT, state_LINE, state_RECT, state_CIRC, state_PIX, state_ERR};
+enum {state_TEXT, state_LINE, state_RECT, state_CIRC, state_PIX, state_POLY, state_TRI, state_OBJ, state_SPR, state_COMMIT, state_GC, state_IMG, state_PAN, state_FONT, state_ERR};
 
 u32* tx_vir_buffer;
 
-static unsigned int strToInt(const char* string_num)
+// while a tile is drawn (TileBatch.h) drawing goes to its scratch rows instead of the frame,
+// the first scratch row stands for frame row draw_tile_y0
+static u32* draw_tile = NULL;
+static int draw_tile_y0 = 0;
+
+// inclusive screen area, x1 < x0 or y1 < y0 is empty
+struct Box
 {
-	int i,dec=1;
-	unsigned int val=0;
-	for(i=strlen(string_num)-1;i>=0;--i)
+	int x0, y0, x1, y1;
+};
+
+// drawing is limited to this area, the scene narrows it down while it repaints damaged parts
+static struct Box clip = {0, 0, MAX_W, MAX_H};
+
+#include "PixelKernels.h"
+#include "Overdraw.h"
+#include "DrawChunk.h"
+
+// first pixel of frame row y where drawing goes, y is inside the clip box
+static inline u32* draw_row(const int y)
+{
+	return unlikely(draw_tile) ? draw_tile + 640*(y - draw_tile_y0) : tx_vir_buffer + 640*y;
+}
+
+// decimal number, anything but digits (or a number past UINT_MAX) is an error
+static int strToInt(const char* string_num, unsigned int* val)
+{
+	const char* c = string_num;
+	u64 v = 0;
+	for(; *c >= '0' && *c <= '9' && v <= UINT_MAX; ++c)
+		v = v*10 + (*c - '0');
+	if(c == string_num || *c || v > UINT_MAX)
 	{
-		unsigned int tmp = (string_num[i]-48)*dec;
-		dec *= 10;
-		val += tmp;
+		printk(KERN_ERR "VGA_DMA: %s is not appropriate number\n", string_num);
+		return -1;
 	}
-	return val;
+	*val = (unsigned int)v;
+	return 0;
 }
 
-static void parse_buffer(const char* buffer, char(* commands)[BUFF_SIZE])
+// splits the command line in place in one pass, every ';' becomes the end of a field and
+// commands[i] points to field i, the ones past the last field point to "" (commands has CMD_FIELDS+1 places)
+static int parse_buffer(char* buffer, const char** commands)
 {
-	int i, incr=0, len=0;
-	for(i=0;i<strlen(buffer);i++)
+	int i, incr = 0;
+	commands[incr++] = buffer;
+	for(; *buffer && *buffer != '\n'; ++buffer)
 	{
-		if(buffer[i] != ';' && buffer[i] != '\n')
-			commands[incr][i-len] = buffer[i];
-		else if(buffer[i] == ';')
-		{
-			len += strlen(commands[incr]) + 1;
-			incr++;
-		}
-		else if(buffer[i] == '\n')
-		{
+		if(*buffer != ';')
+			continue;
+		*buffer = '\0';
+		if(incr == CMD_FIELDS)
 			break;
+		commands[incr++] = buffer + 1;
+	}
+	*buffer = '\0';
+	for(i=incr; i<=CMD_FIELDS; ++i)
+		commands[i] = "";
+	return incr;
+}
+
+static void fill_span(const int y, int x0, int x1, const u32 color)
+{
+	u32* row;
+	if(y < clip.y0 || y > clip.y1)
+		return;
+	draw_yield();
+	row = draw_row(y);
+	if(x0 < clip.x0)
+		x0 = clip.x0;
+	if(x1 > clip.x1)
+		x1 = clip.x1;
+	if(x0 <= x1)
+		pk->fill32(row + x0, color, x1 - x0 + 1);
+}
+
+static inline void put_pixel(const int x, const int y, const u32 color)
+{
+	if(x >= clip.x0 && x <= clip.x1 && y >= clip.y0 && y <= clip.y1)
+	{
+		u32* px = draw_row(y) + x;
+		if(unlikely(overdraw_on))
+			overdraw_add(px, 1);
+		*px = color;
+	}
+}
+
+// alpha 255 is the plain opaque path, 0 draws nothing
+static void fill_span_alpha(const int y, int x0, int x1, const u32 color, const u8 alpha)
+{
+	if(alpha == 255)
+	{
+		fill_span(y, x0, x1, color);
+		return;
+	}
+	if(alpha == 0 || y < clip.y0 || y > clip.y1)
+		return;
+	draw_yield();
+	if(x0 < clip.x0)
+		x0 = clip.x0;
+	if(x1 > clip.x1)
+		x1 = clip.x1;
+	if(x0 <= x1)
+		pk->blend32(draw_row(y) + x0, color, x1 - x0 + 1, alpha);
+}
+
+static inline void put_pixel_alpha(const int x, const int y, const u32 color, const u8 alpha)
+{
+	if(x >= clip.x0 && x <= clip.x1 && y >= clip.y0 && y <= clip.y1 && alpha)
+	{
+		u32* px = draw_row(y) + x;
+		if(unlikely(overdraw_on))
+			overdraw_add(px, 1);
+		*px = (alpha == 255) ? color : blend_pixel32(color, *px, alpha);
+	}
+}
+
+// COLOR or COLOR@ALPHA, alpha goes from 0 (invisible) to 255 (opaque, default)
+static int parse_color(const char* field, unsigned long long* color, u8* alpha)
+{
+	char buff[BUFF_SIZE];
+	char* at;
+	unsigned int a = 255;
+	strlcpy(buff, field, BUFF_SIZE);
+	at = strchr(buff, '@');
+	if(at)
+	{
+		*at++ = '\0';
+		if(kstrtouint(at, 0, &a) || a > 255)
+		{
+			printk(KERN_ERR "VGA_DMA: %s is not appropriate alpha (0-255)\n", at);
+			return -1;
 		}
 	}
+	if(kstrtoull(buff, 0, color))
+	{
+		printk(KERN_ERR "VGA_DMA: %s is not appropriate color\n", buff);
+		return -1;
+	}
+	*alpha = (u8)a;
+	return 0;
+}
+
+struct Keyword
+{
+	const char *lower, *upper;	// a command is written in one of the two
+	state_t state;
+};
+
+static const struct Keyword keywords[] =
+{
+	{"text", "TEXT", state_TEXT}, {"line", "LINE", state_LINE}, {"rect", "RECT", state_RECT},
+	{"circ", "CIRC", state_CIRC}, {"pix", "PIX", state_PIX}, {"poly", "POLY", state_POLY},
+	{"tri", "TRI", state_TRI}, {"obj", "OBJ", state_OBJ}, {"spr", "SPR", state_SPR},
+	{"commit", "COMMIT", state_COMMIT}, {"gc", "GC", state_GC}, {"img", "IMG", state_IMG},
+	{"pan", "PAN", state_PAN}, {"font", "FONT", state_FONT}
+};
+
+// keyword hash table, slot holds index+1 into keywords, 0 is empty
+#define KEYWORD_HASH_SIZE 32
+static u8 keyword_slot[KEYWORD_HASH_SIZE];
+
+// case folded, so both spellings of a keyword land in the same slot
+static inline unsigned int keyword_hash(const char* word)
+{
+	unsigned int h = 0;
+	for(; *word; ++word)
+		h = h*31 + (*word | 0x20);
+	return h & (KEYWORD_HASH_SIZE-1);
+}
+
+static void keywords_init(void)
+{
+	unsigned int i, h;
+	memset(keyword_slot, 0, sizeof(keyword_slot));
+	for(i=0; i<ARRAY_SIZE(keywords); ++i)
+	{
+		for(h=keyword_hash(keywords[i].lower); keyword_slot[h]; h=(h+1) & (KEYWORD_HASH_SIZE-1));
+		keyword_slot[h] = i+1;
+	}
 }
 
 static state_t getState(const char* command0)
 {
-	if(!strcmp(command0,"TEXT") || !strcmp(command0,"text") )
-		return state_TEXT;
-	else if(!strcmp(command0,"LINE") || !strcmp(command0,"line") )
-		return state_LINE;
-	else if(!strcmp(command0,"RECT") || !strcmp(command0,"rect") )
-		return state_RECT;
-	else if(!strcmp(command0,"CIRC") || !strcmp(command0,"circ") )
-		return state_CIRC;
-	else if(!strcmp(command0,"PIX")  || !strcmp(command0,"pix" ) )
-		return state_PIX;
+	unsigned int h;
+	for(h=keyword_hash(command0); keyword_slot[h]; h=(h+1) & (KEYWORD_HASH_SIZE-1))
+	{
+		const struct Keyword* k = &keywords[keyword_slot[h]-1];
+		if(!strcmp(command0, k->lower) || !strcmp(command0, k->upper))
+			return k->state;
+	}
 	printk(KERN_ERR "%s is not appropriate command\n",command0);
 	return state_ERR;
 }
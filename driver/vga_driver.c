@@ -20,8 +20,25 @@
 #include <linux/dma-mapping.h>  //dma access
 #include <linux/mm.h>  //dma access
 #include <linux/interrupt.h>  //interrupt handlers
+#include <linux/vmalloc.h>  //vmalloc vfree
+#include <linux/ktime.h>  //ktime_get
+#include <linux/math64.h>  //div64_u64
+#include <linux/mutex.h>  //mutex_lock mutex_unlock
+#include <linux/workqueue.h>  //schedule_work
+#include <linux/spinlock.h>  //spin_lock
+#include <linux/timer.h>  //timer_setup mod_timer
+#include <linux/jiffies.h>  //msecs_to_jiffies
+#include <linux/poll.h>  //poll_wait
+#include <linux/delay.h>  //usleep_range
+
+#define CREATE_TRACE_POINTS
+#include "include/VgaTrace.h"
 
 #include "include/commands.h"
+#include "include/VgaFb.h"
+#include "include/VgaIoctl.h"
+#include "include/Ring.h"
+#include "include/Stream.h"
 
 MODULE_AUTHOR ("FTN");
 MODULE_DESCRIPTION("Test Driver for VGA controller IP.");
@@ -31,7 +48,18 @@ MODULE_ALIAS("custom:vga_dma controller");
 #define DEVICE_NAME "vga_dma"
 #define DRIVER_NAME "vga_dma_driver"
 
-#define MAX_PKT_LEN 640*480*4
+#define MAX_PKT_LEN 640*480*4 // one screen, the frame buffer is vga_size bytes
+#define WRITE_BUFF_SIZE 4096
+
+// MM2S_DMASR bits
+#define DMASR_HALTED	(1 << 0)
+#define DMASR_INT_ERR	(1 << 4)
+#define DMASR_SLV_ERR	(1 << 5)
+#define DMASR_DEC_ERR	(1 << 6)
+#define DMASR_ERR_IRQ	(1 << 14)
+#define DMASR_ERRORS	(DMASR_INT_ERR | DMASR_SLV_ERR | DMASR_DEC_ERR | DMASR_ERR_IRQ)
+#define DMA_RESET_TIMEOUT 1000 // register reads while waiting for the reset bit to clear
+#define DMA_HALT_TIMEOUT_MS 50 // a frame takes ~17 ms, the DMA halts at its end
 
 //*******************FUNCTION PROTOTYPES************************************
 static int vga_dma_probe(struct platform_device *pdev);
@@ -39,12 +67,23 @@ static int vga_dma_open(struct inode *i, struct file *f);
 static int vga_dma_close(struct inode *i, struct file *f);
 static ssize_t vga_dma_read(struct file *f, char __user *buf, size_t len, loff_t *off);
 static ssize_t vga_dma_write(struct file *f, const char __user *buf, size_t length, loff_t *off);
+static ssize_t vga_dma_write_iter(struct kiocb *iocb, struct iov_iter *from);
 static ssize_t vga_dma_mmap(struct file *f, struct vm_area_struct *vma_s);
+static long vga_dma_ioctl(struct file *f, unsigned int cmd, unsigned long arg);
+static __poll_t vga_dma_poll(struct file *f, poll_table *wait);
 static int __init vga_dma_init(void);
 static void __exit vga_dma_exit(void);
 static int vga_dma_remove(struct platform_device *pdev);
 
 static irqreturn_t dma_isr(int irq,void*dev_id);
+static void commit_work_fn(struct work_struct *work);
+static void ring_work_fn(struct work_struct *work);
+static void dma_watchdog_fn(struct timer_list *t);
+static void defio_work_fn(struct work_struct *work);
+static void blank_idle_fn(struct work_struct *work);
+static int vga_wake(void);
+static int vga_buffer_restore(void);
+static int vga_blank(const int level, const bool idle);
 int dma_init(void __iomem *base_address);
 u32 dma_simple_write(dma_addr_t TxBufferPtr, u32 max_pkt_len, void __iomem *base_address); 
 
@@ -61,6 +100,34 @@ static dev_t my_dev_id;
 static struct class *my_class;
 static struct device *my_device;
 static struct vga_dma_info *vp = NULL;
+static DEFINE_MUTEX(vga_lock); // serializes drawing and the scene between writers
+static DECLARE_WORK(commit_work, commit_work_fn);
+static DECLARE_WORK(ring_work, ring_work_fn);
+
+struct dma_stats {
+  unsigned long frames;
+  unsigned long int_err, slv_err, dec_err, halted;
+  unsigned long restarts, watchdog;
+};
+
+static struct dma_stats dma_stats;
+static DEFINE_SPINLOCK(dma_lock); // dma_isr and the watchdog both restart the channel
+static struct timer_list dma_watchdog;
+static unsigned long dma_watchdog_frames;
+static unsigned int dma_watchdog_ms = 100;
+module_param(dma_watchdog_ms, uint, 0444);
+MODULE_PARM_DESC(dma_watchdog_ms, "Restart the DMA when no frame completes within this many ms (0 - no watchdog)");
+
+static bool dma_probed = false;
+static bool dma_blanked = false; // dma_lock, dma_isr doesn't start the next frame
+static int blank_level = VGA_BLANK_OFF;
+static bool blank_by_idle = false; // an idle blank ends with the next write
+static atomic_t vga_maps = ATOMIC_INIT(0); // mappings of the frame buffer, it isn't dropped while there are any
+static unsigned int vga_draw_line; // first line drawn to, kept while the frame buffer is dropped
+static DECLARE_DELAYED_WORK(blank_idle_work, blank_idle_fn);
+static unsigned int blank_idle_s = 0;
+module_param(blank_idle_s, uint, 0644);
+MODULE_PARM_DESC(blank_idle_s, "Blank the display after this many seconds without writes (0 - never)");
 
 static struct file_operations my_fops =
 {
@@ -69,7 +136,11 @@ static struct file_operations my_fops =
 	.release = vga_dma_close,
 	.read = vga_dma_read,
 	.write = vga_dma_write,
-	.mmap = vga_dma_mmap
+	.write_iter = vga_dma_write_iter,
+	.splice_write = iter_file_splice_write,
+	.mmap = vga_dma_mmap,
+	.unlocked_ioctl = vga_dma_ioctl,
+	.poll = vga_dma_poll
 };
 
 static struct of_device_id vga_dma_of_match[] = {
@@ -90,6 +161,7 @@ static struct platform_driver vga_dma_driver = {
 };
 
 dma_addr_t tx_phy_buffer;
+static size_t vga_size; // virtual_lines lines
 
 //***************************************************************************
 // PROBE AND REMOVE
@@ -147,11 +219,18 @@ static int vga_dma_probe(struct platform_device *pdev)
 	}
 	else {
 		printk(KERN_INFO "vga_dma_probe: Registered IRQ %d\n", vp->irq_num);
+		commit_vsync = true;
 	}
 
 	/* INIT DMA */
 	dma_init(vp->base_addr);
-	dma_simple_write(tx_phy_buffer, MAX_PKT_LEN, vp->base_addr); // helper function, defined later
+	dma_simple_write(tx_phy_buffer + pan_offset(), MAX_PKT_LEN, vp->base_addr); // helper function, defined later
+	if(dma_watchdog_ms)
+	{
+		timer_setup(&dma_watchdog, dma_watchdog_fn, 0);
+		mod_timer(&dma_watchdog, jiffies + msecs_to_jiffies(dma_watchdog_ms));
+	}
+	dma_probed = true;
 
 	printk(KERN_NOTICE "vga_dma_probe: VGA platform driver registered\n");
 	return 0;//ALL OK
@@ -170,9 +249,17 @@ static int vga_dma_remove(struct platform_device *pdev)
 	u32 reset = 0x00000004;
 	// writing to MM2S_DMACR register. Seting reset bit (3. bit)
 	printk(KERN_INFO "vga_dma_probe: resseting");
+	if(dma_watchdog_ms)
+		del_timer_sync(&dma_watchdog);
 	iowrite32(reset, vp->base_addr); 
 
 	free_irq(vp->irq_num, NULL);
+	mutex_lock(&vga_lock);
+	dma_probed = false;
+	commit_vsync = false;
+	mutex_unlock(&vga_lock);
+	cancel_work_sync(&commit_work);
+	cancel_work_sync(&ring_work);
 	iounmap(vp->base_addr);
 	release_mem_region(vp->mem_start, vp->mem_end - vp->mem_start + 1);
 	kfree(vp);
@@ -184,12 +271,39 @@ static int vga_dma_remove(struct platform_device *pdev)
 // IMPLEMENTATION OF FILE OPERATION FUNCTIONS
 static int vga_dma_open(struct inode *i, struct file *f)
 {
+	// every open file draws with its own colors, font, origin and clip
+	struct GContext* gc = kmalloc(sizeof(*gc), GFP_KERNEL);
+	if(!gc)
+		return -ENOMEM;
+	gc_init(gc);
+	gc->ring = NULL;
+	gc->stream = NULL;
+	mutex_lock(&vga_lock);
+	commit_open(gc);
+	mutex_unlock(&vga_lock);
+	f->private_data = gc;
 	printk(KERN_INFO "vga_dma opened\n");
 	return 0;
 }
 
 static int vga_dma_close(struct inode *i, struct file *f)
 {
+	struct GContext* gc = f->private_data;
+	mutex_lock(&vga_lock);
+	ring_free(gc->ring);
+	if((gc->commit_queued || (gc->stream && gc->stream->len)) && !vga_wake())
+	{
+		// a last command without a newline runs now, a batch left without commit is shown
+		if(gc->stream && gc->stream->len)
+			stream_end(gc);
+		if(gc->commit_queued)
+			commit_now(gc);
+		scene_flush();
+	}
+	commit_close(gc);
+	mutex_unlock(&vga_lock);
+	kfree(gc->stream);
+	kfree(gc);
 	printk(KERN_INFO "vga_dma closed\n");
 	return 0;
 }
@@ -200,31 +314,106 @@ static ssize_t vga_dma_read(struct file *f, char __user *buf, size_t len, loff_t
 	return 0;
 }
 
+static void vga_vm_open(struct vm_area_struct *vma)
+{
+	atomic_inc(&vga_maps);
+}
+
+static void vga_vm_close(struct vm_area_struct *vma)
+{
+	atomic_dec(&vga_maps);
+}
+
+static const struct vm_operations_struct vga_vm_ops =
+{
+	.open = vga_vm_open,
+	.close = vga_vm_close,
+};
+
 static ssize_t vga_dma_write(struct file *f, const char __user *buf, size_t length, loff_t *off)
 {	
-	char buff[2*BUFF_SIZE];
+	char *buff, *line, *next, *end;
+	const char* commands[CMD_FIELDS+1];
+	size_t chunk = min_t(size_t, length, WRITE_BUFF_SIZE);
 	int ret = 0;
-	char commands[7][BUFF_SIZE] = {{0}};
-	state_t state;
-	int i;
-	
-	printk("\n");
 
-	ret = copy_from_user(buff, buf, length);  
+	buff = kmalloc(chunk + 1, GFP_KERNEL);
+	if(!buff)
+	{
+		ret = -ENOMEM;
+		goto out;
+	}
+	ret = copy_from_user(buff, buf, chunk);  
 	if(ret){
 		printk("copy from user failed \n");
-		return -EFAULT;
+		ret = -EFAULT;
+		goto out;
 	}  
-	buff[length] = '\0';
-	
-	parse_buffer(buff, commands);
-	for(i=0; i<7;++i)
-		printk("%d: %s\n", i, commands[i]);
+	buff[chunk] = '\0';
+
+	// a batch bigger than one chunk is consumed up to its last whole command,
+	// the caller's write loop hands the rest over in the next call
+	end = buff + chunk;
+	if(chunk < length)
+	{
+		end = strrchr(buff, '\n');
+		if(!end)
+		{
+			printk(KERN_ERR "vga_dma: command longer than %d bytes\n", WRITE_BUFF_SIZE);
+			ret = -EINVAL;
+			goto out;
+		}
+		*end++ = '\0';
+	}
 
-	state = getState(commands[0]);
-	ret = assign_params_from_commands(state, commands);
+	mutex_lock(&vga_lock);
+	ret = vga_wake();
+	if(ret)
+	{
+		mutex_unlock(&vga_lock);
+		goto out;
+	}
+	// commands are split in place, so the next line is found before the command is run
+	for(line = buff; line < end; line = next)
+	{
+		char *nl = strchr(line, '\n');
+		next = nl ? nl + 1 : end;
+		if(nl)
+			*nl = '\0';
+		if(*line)
+			exec_command(line, commands, f->private_data);
+	}
+	commit_write_done(f->private_data);
+	// objects changed by this write are repainted once, after all of its commands
+	scene_flush();
+	mutex_unlock(&vga_lock);
+	ret = end - buff;
+
+out:
+	kfree(buff);
+	return ret;
+}
 
-	return length;
+// splice()/sendfile() (through iter_file_splice_write) and writev() come here, write() keeps
+// taking its own path. Commands may be cut anywhere, the stream buffer puts them together.
+static ssize_t vga_dma_write_iter(struct kiocb *iocb, struct iov_iter *from)
+{
+	struct GContext* gc = iocb->ki_filp->private_data;
+	const size_t length = iov_iter_count(from);
+	int ret;
+
+	mutex_lock(&vga_lock);
+	if(!gc->stream)
+		gc->stream = stream_alloc();
+	ret = gc->stream ? vga_wake() : -ENOMEM;
+	if(!ret)
+	{
+		ret = stream_write(gc, from);
+		commit_write_done(gc);
+		scene_flush();
+	}
+	mutex_unlock(&vga_lock);
+	return ret ? ret : length;
 }
 
 static ssize_t vga_dma_mmap(struct file *f, struct vm_area_struct *vma_s)
@@ -234,24 +423,141 @@ static ssize_t vga_dma_mmap(struct file *f, struct vm_area_struct *vma_s)
 
 	//printk(KERN_INFO "DMA TX Buffer is being memory mapped\n");
 
-	if(length > MAX_PKT_LEN)
+	if(vma_s->vm_pgoff == DEFIO_PGOFF)
+	{
+		mutex_lock(&vga_lock);
+		// the shadow starts as a copy of the frame buffer, a dropped one is allocated first
+		ret = vga_buffer_restore();
+		if(!ret)
+			ret = defio_mmap(vma_s);
+		mutex_unlock(&vga_lock);
+		return ret;
+	}
+	if(vma_s->vm_pgoff == RING_PGOFF)
+	{
+		mutex_lock(&vga_lock);
+		ret = ring_mmap(f->private_data, vma_s);
+		mutex_unlock(&vga_lock);
+		return ret;
+	}
+
+	if(length > vga_size)
 	{
 		return -EIO;
 		printk(KERN_ERR "Trying to mmap more space than it's allocated\n");
 	}
 
-	ret = dma_mmap_coherent(NULL, vma_s, tx_vir_buffer, tx_phy_buffer, length);
+	mutex_lock(&vga_lock);
+	ret = vga_buffer_restore();
+	if(!ret)
+		ret = dma_mmap_coherent(NULL, vma_s, vga_base, tx_phy_buffer, length);
 	if(ret<0)
 	{
+		mutex_unlock(&vga_lock);
 		printk(KERN_ERR "memory map failed\n");
 		return ret;
 	}
+	// counted, so the frame buffer isn't freed under a mapping
+	vma_s->vm_ops = &vga_vm_ops;
+	vga_vm_open(vma_s);
+	mutex_unlock(&vga_lock);
 	return 0;
 }
 
+// runs the commands queued in the ring like one write, called with vga_lock held
+static int vga_ring_run(struct VgaRing* ring)
+{
+	int ret;
+	if(!ring_pending(ring))
+		return 0;
+	ret = vga_wake();
+	if(ret)
+		return ret;
+	ret = ring_run(ring);
+	commit_write_done(ring->gc);
+	scene_flush();
+	return ret;
+}
+
+static long vga_dma_ioctl(struct file *f, unsigned int cmd, unsigned long arg)
+{
+	struct GContext* gc = f->private_data;
+	struct vga_font* font;
+	long ret;
+	switch(cmd)
+	{
+		case VGA_IOC_BLANK:
+			mutex_lock(&vga_lock);
+			ret = vga_blank((int)arg, false);
+			mutex_unlock(&vga_lock);
+			return ret;
+		case VGA_IOC_FONT:
+			font = memdup_user((const void __user*)arg, sizeof(*font));
+			if(IS_ERR(font))
+				return PTR_ERR(font);
+			mutex_lock(&vga_lock);
+			ret = font_set(font);
+			// text objects are repainted with the new font
+			scene_flush();
+			mutex_unlock(&vga_lock);
+			kfree(font);
+			return ret;
+		case VGA_IOC_RING_ENTER:
+		case VGA_IOC_RING_POLL:
+			mutex_lock(&vga_lock);
+			// the ring is made by its first mapping
+			if(!gc->ring)
+				ret = -ENXIO;
+			else if(cmd == VGA_IOC_RING_ENTER)
+				ret = vga_ring_run(gc->ring);
+			else
+			{
+				ring_set_poll(gc->ring, arg != 0);
+				ret = 0;
+			}
+			mutex_unlock(&vga_lock);
+			return ret;
+	}
+	return -ENOTTY;
+}
+
+// readable when the ring of the file has completions the client didn't take yet
+static __poll_t vga_dma_poll(struct file *f, poll_table *wait)
+{
+	struct GContext* gc = f->private_data;
+	struct VgaRing* ring = READ_ONCE(gc->ring);
+	__poll_t mask = EPOLLOUT | EPOLLWRNORM;
+	if(!ring)
+		return mask;
+	poll_wait(f, &ring->wait, wait);
+	if(ring_completions(ring))
+		mask |= EPOLLIN | EPOLLRDNORM;
+	return mask;
+}
+
 /****************************************************/
 // IMPLEMENTATION OF DMA related functions
 
+static void dma_count_errors(const u32 status)
+{
+	if(status & DMASR_INT_ERR)
+		dma_stats.int_err++;
+	if(status & DMASR_SLV_ERR)
+		dma_stats.slv_err++;
+	if(status & DMASR_DEC_ERR)
+		dma_stats.dec_err++;
+	if(status & DMASR_HALTED)
+		dma_stats.halted++;
+}
+
+// soft reset and a new transfer, called with dma_lock held
+static void dma_restart(void)
+{
+	dma_init(vp->base_addr);
+	dma_simple_write(tx_phy_buffer + pan_offset(), MAX_PKT_LEN, vp->base_addr);
+	dma_stats.restarts++;
+}
+
 static irqreturn_t dma_isr(int irq,void*dev_id)
 {
 	u32 IrqStatus;  
@@ -260,11 +566,250 @@ static irqreturn_t dma_isr(int irq,void*dev_id)
 	iowrite32(IrqStatus | 0x00007000, vp->base_addr + 4);//clear irq status in MM2S_DMASR register
 	//(clearing is done by writing 1 on 13. bit in MM2S_DMASR (IOC_Irq)
 
-	/*Send a transaction*/
-	dma_simple_write(tx_phy_buffer, MAX_PKT_LEN, vp->base_addr); //My function that starts a DMA transaction
+	spin_lock(&dma_lock);
+	if(dma_blanked)
+	{
+		// the last frame before blanking, the channel stays halted
+	}
+	else if(IrqStatus & (DMASR_ERRORS | DMASR_HALTED))
+	{
+		// an error halts the channel, it only runs again after a reset
+		dma_count_errors(IrqStatus);
+		printk_ratelimited(KERN_ERR "vga_dma: DMA error, DMASR 0x%08x, restarting\n", IrqStatus);
+		dma_restart();
+	}
+	else
+	{
+		dma_stats.frames++;
+		overdraw_frame_done();
+		/*Send a transaction*/
+		// the start address is set for every frame, so a new pan line shows from the next one on
+		dma_simple_write(tx_phy_buffer + pan_offset(), MAX_PKT_LEN, vp->base_addr); //My function that starts a DMA transaction
+	}
+	spin_unlock(&dma_lock);
+	// the frame just went out, committed commands are drawn before the next one gets far
+	if(READ_ONCE(commit_pending))
+		schedule_work(&commit_work);
+	if(READ_ONCE(ring_pollers))
+		schedule_work(&ring_work);
 	return IRQ_HANDLED;;
 }
 
+// a channel that stopped without raising an interrupt is noticed here
+static void dma_watchdog_fn(struct timer_list *t)
+{
+	unsigned long flags;
+	spin_lock_irqsave(&dma_lock, flags);
+	if(dma_stats.frames == dma_watchdog_frames)
+	{
+		const u32 status = ioread32(vp->base_addr + 4);
+		dma_stats.watchdog++;
+		dma_count_errors(status);
+		printk_ratelimited(KERN_ERR "vga_dma: no frame in %u ms, DMASR 0x%08x, restarting\n", dma_watchdog_ms, status);
+		dma_restart();
+	}
+	dma_watchdog_frames = dma_stats.frames;
+	spin_unlock_irqrestore(&dma_lock, flags);
+	mod_timer(&dma_watchdog, jiffies + msecs_to_jiffies(dma_watchdog_ms));
+}
+
+static ssize_t dma_stats_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+	return sprintf(buf, "frames %lu\nint_err %lu\nslv_err %lu\ndec_err %lu\nhalted %lu\nrestarts %lu\nwatchdog %lu\n",
+		dma_stats.frames, dma_stats.int_err, dma_stats.slv_err, dma_stats.dec_err, dma_stats.halted,
+		dma_stats.restarts, dma_stats.watchdog);
+}
+static DEVICE_ATTR_RO(dma_stats);
+
+/****************************************************/
+// BLANKING
+
+// clears RS and waits for the channel to finish its frame, a reset stops it if it doesn't
+static void dma_halt(void)
+{
+	unsigned long flags;
+	int timeout = DMA_HALT_TIMEOUT_MS;
+
+	spin_lock_irqsave(&dma_lock, flags);
+	dma_blanked = true;
+	iowrite32(ioread32(vp->base_addr) & ~0x1, vp->base_addr); // clear RS bit in MM2S_DMACR register
+	spin_unlock_irqrestore(&dma_lock, flags);
+	while(!(ioread32(vp->base_addr + 4) & DMASR_HALTED) && --timeout)
+		usleep_range(1000, 2000);
+	if(!timeout)
+	{
+		printk(KERN_WARNING "vga_dma: DMA didn't halt in %d ms, resetting it\n", DMA_HALT_TIMEOUT_MS);
+		iowrite32(0x4, vp->base_addr); // reset bit in MM2S_DMACR register
+	}
+}
+
+static void dma_unhalt(void)
+{
+	unsigned long flags;
+	spin_lock_irqsave(&dma_lock, flags);
+	dma_blanked = false;
+	dma_init(vp->base_addr);
+	dma_simple_write(tx_phy_buffer + pan_offset(), MAX_PKT_LEN, vp->base_addr);
+	dma_watchdog_frames = dma_stats.frames;
+	spin_unlock_irqrestore(&dma_lock, flags);
+}
+
+// frees the frame buffer, called with vga_lock held and the DMA halted
+static void vga_buffer_drop(void)
+{
+	vga_draw_line = (tx_vir_buffer - vga_base)/640;
+	dma_free_coherent(NULL, vga_size, vga_base, tx_phy_buffer);
+	vga_base = NULL;
+	tx_vir_buffer = NULL;
+	printk(KERN_INFO "vga_dma: frame buffer dropped (%zu bytes)\n", vga_size);
+}
+
+// allocates a dropped frame buffer again, what was drawn right away is lost, the shadow mapping,
+// objects and sprites are put back; called with vga_lock held
+static int vga_buffer_restore(void)
+{
+	const struct Box screen = {0, 0, MAX_W, MAX_H};
+	u32* buffer;
+
+	if(vga_base)
+		return 0;
+	buffer = dma_alloc_coherent(NULL, vga_size, &tx_phy_buffer, GFP_DMA | GFP_KERNEL);
+	if(!buffer)
+	{
+		printk(KERN_ERR "vga_dma: could not allocate the frame buffer again\n");
+		return -ENOMEM;
+	}
+	memset(buffer, 0, vga_size);
+	vga_base = buffer;
+	tx_vir_buffer = buffer + 640*vga_draw_line;
+	vga_fb_resume(vga_base, tx_phy_buffer);
+	if(blank_level == VGA_BLANK_DROP)
+		blank_level = VGA_BLANK_ON;
+	if(defio_shadow)
+	{
+		memcpy(tx_vir_buffer, defio_shadow, DEFIO_SIZE);
+		defio_flush();
+	}
+	if(!list_empty(&scene_objects))
+	{
+		scene_add_damage(screen);
+		scene_flush();
+	}
+	else if(!list_empty(&sprites))
+	{
+		// the saved pixels under the sprites are put back too
+		sprites_lift(list_first_entry(&sprites, struct Sprite, list));
+		sprites_drop(sprites.next);
+	}
+	return 0;
+}
+
+// VGA_BLANK_OFF/ON/DROP, called with vga_lock held
+static int vga_blank(const int level, const bool idle)
+{
+	int ret;
+	if(level < VGA_BLANK_OFF || level > VGA_BLANK_DROP)
+		return -EINVAL;
+	if(level == blank_level)
+		return 0;
+	if(level == VGA_BLANK_DROP && vga_base && (atomic_read(&vga_maps) || vga_fb_suspend()))
+	{
+		printk(KERN_WARNING "vga_dma: the frame buffer is mapped, it can't be dropped\n");
+		return -EBUSY;
+	}
+	if(level != VGA_BLANK_DROP && (ret = vga_buffer_restore()))
+		return ret;
+
+	if(blank_level == VGA_BLANK_OFF)
+	{
+		if(dma_probed)
+		{
+			if(dma_watchdog_ms)
+				del_timer_sync(&dma_watchdog);
+			dma_halt();
+		}
+		// no frame interrupts while blanked, commits are drawn right away
+		commit_vsync = false;
+		if(READ_ONCE(commit_pending))
+			commit_apply();
+	}
+	else if(level == VGA_BLANK_OFF && dma_probed)
+	{
+		dma_unhalt();
+		commit_vsync = true;
+		if(dma_watchdog_ms)
+			mod_timer(&dma_watchdog, jiffies + msecs_to_jiffies(dma_watchdog_ms));
+	}
+	if(level == VGA_BLANK_DROP && vga_base)
+		vga_buffer_drop();
+	blank_level = level;
+	blank_by_idle = idle;
+	printk(KERN_INFO "vga_dma: %s\n", level == VGA_BLANK_OFF ? "unblanked" : idle ? "blanked after idle timeout" : "blanked");
+	return 0;
+}
+
+// every write ends an idle blank and needs the frame buffer, called with vga_lock held
+static int vga_wake(void)
+{
+	if(blank_idle_s)
+		mod_delayed_work(system_wq, &blank_idle_work, msecs_to_jiffies(blank_idle_s*1000));
+	if(blank_by_idle)
+		return vga_blank(VGA_BLANK_OFF, false);
+	return vga_buffer_restore();
+}
+
+static void blank_idle_fn(struct work_struct *work)
+{
+	mutex_lock(&vga_lock);
+	if(blank_idle_s && blank_level == VGA_BLANK_OFF)
+		vga_blank(VGA_BLANK_ON, true);
+	mutex_unlock(&vga_lock);
+}
+
+static ssize_t blank_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+	return sprintf(buf, "%d\n", blank_level);
+}
+
+static ssize_t blank_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count)
+{
+	int level, ret;
+	if(kstrtoint(buf, 10, &level))
+		return -EINVAL;
+	mutex_lock(&vga_lock);
+	ret = vga_blank(level, false);
+	mutex_unlock(&vga_lock);
+	return ret ? ret : count;
+}
+static DEVICE_ATTR_RW(blank);
+
+static void commit_work_fn(struct work_struct *work)
+{
+	mutex_lock(&vga_lock);
+	if(vga_base)
+		commit_apply();
+	mutex_unlock(&vga_lock);
+}
+
+// rings in poll mode are looked at once a frame
+static void ring_work_fn(struct work_struct *work)
+{
+	struct VgaRing* ring;
+	mutex_lock(&vga_lock);
+	list_for_each_entry(ring, &ring_polled, list)
+		vga_ring_run(ring);
+	mutex_unlock(&vga_lock);
+}
+
+static void defio_work_fn(struct work_struct *work)
+{
+	mutex_lock(&vga_lock);
+	// a dropped frame buffer gets the whole shadow when it's allocated again
+	if(vga_base)
+		defio_flush();
+	mutex_unlock(&vga_lock);
+}
+
 int dma_init(void __iomem *base_address)
 {
 	u32 reset = 0x00000004;
@@ -272,11 +817,14 @@ int dma_init(void __iomem *base_address)
 	u32 ERR_IRQ_EN;
 	u32 MM2S_DMACR_reg;
 	u32 en_interrupt;
+	u32 timeout = DMA_RESET_TIMEOUT;
 
 	IOC_IRQ_EN = 1 << 12; // this is IOC_IrqEn bit in MM2S_DMACR register
 	ERR_IRQ_EN = 1 << 14; // this is Err_IrqEn bit in MM2S_DMACR register
 
 	iowrite32(reset, base_address); // writing to MM2S_DMACR register. Seting reset bit (3. bit)
+	while((ioread32(base_address) & reset) && --timeout) // reset bit clears itself when the reset is done
+		cpu_relax();
 
 	MM2S_DMACR_reg = ioread32(base_address); // Reading from MM2S_DMACR register inside DMA
 	en_interrupt = MM2S_DMACR_reg | IOC_IRQ_EN | ERR_IRQ_EN;// seting 13. and 15.th bit in MM2S_DMACR
@@ -311,6 +859,10 @@ static int __init vga_dma_init(void)
 	int i = 0;
 
 	printk(KERN_INFO "vga_dma_init: Initialize Module \"%s\"\n", DEVICE_NAME);
+	pixel_kernels_init();
+	keywords_init();
+	raster_init();
+	INIT_DELAYED_WORK(&defio_work, defio_work_fn);
 	ret = alloc_chrdev_region(&my_dev_id, 0, 1, "VGA_region");
 	if (ret)
 	{
@@ -332,6 +884,10 @@ static int __init vga_dma_init(void)
 	}
 
 	printk(KERN_INFO "vga_dma_init: Device created\n");
+	if(device_create_file(my_device, &dev_attr_dma_stats))
+		printk(KERN_WARNING "vga_dma_init: Failed to create dma_stats attribute\n");
+	if(device_create_file(my_device, &dev_attr_blank))
+		printk(KERN_WARNING "vga_dma_init: Failed to create blank attribute\n");
 
 	my_cdev = cdev_alloc();	
 	my_cdev->ops = &my_fops;
@@ -344,16 +900,22 @@ static int __init vga_dma_init(void)
 	}
 	printk(KERN_INFO "vga_dma_init: Module init done\n");
 
-	tx_vir_buffer = dma_alloc_coherent(NULL, MAX_PKT_LEN, &tx_phy_buffer, GFP_DMA | GFP_KERNEL);
+	vga_size = pan_size();
+	tx_vir_buffer = dma_alloc_coherent(NULL, vga_size, &tx_phy_buffer, GFP_DMA | GFP_KERNEL);
 	if(!tx_vir_buffer){
 		printk(KERN_ALERT "vga_dma_init: Could not allocate dma_alloc_coherent for img");
 		goto fail_3;
 	}
 	else
 		printk("vga_dma_init: Successfully allocated memory for dma transaction buffer\n");
-	for (i = 0; i < MAX_PKT_LEN/4;i++)
-		tx_vir_buffer[i] = 0x00000000;
+	pan_init(tx_vir_buffer);
+	for (i = 0; i < vga_size/4;i++)
+		vga_base[i] = 0x00000000;
 	printk(KERN_INFO "vga_dma_init: DMA memory reset.\n");
+	if(vga_fb_init(my_device, vga_base, tx_phy_buffer, vga_size))
+		printk(KERN_WARNING "vga_dma_init: continuing without framebuffer device\n");
+	font_init(my_device);
+	vga_debugfs_init();
 	return platform_driver_register(&vga_dma_driver);
 
 fail_3:
@@ -372,17 +934,31 @@ static void __exit vga_dma_exit(void)
 {
 	//Reset DMA memory
 	int i =0;
-	for (i = 0; i < MAX_PKT_LEN/4; i++) 
-		tx_vir_buffer[i] = 0x00000000;
+	vga_fb_exit();
+	vga_debugfs_exit();
+	cancel_work_sync(&commit_work);
+	cancel_delayed_work_sync(&defio_work);
+	cancel_delayed_work_sync(&blank_idle_work);
+	commit_clear();
+	defio_cleanup();
+	sprite_clear();
+	scene_clear();
+	glyph_cache_clear();
+	// a dropped frame buffer is already freed
+	for (i = 0; vga_base && i < vga_size/4; i++) 
+		vga_base[i] = 0x00000000;
 	printk(KERN_INFO "vga_dma_exit: DMA memory reset\n");
 
 	// Exit Device Module
 	platform_driver_unregister(&vga_dma_driver);
 	cdev_del(my_cdev);
+	device_remove_file(my_device, &dev_attr_dma_stats);
+	device_remove_file(my_device, &dev_attr_blank);
 	device_destroy(my_class, MKDEV(MAJOR(my_dev_id),0));
 	class_destroy(my_class);
 	unregister_chrdev_region(my_dev_id, 1);
-	dma_free_coherent(NULL, MAX_PKT_LEN, tx_vir_buffer, tx_phy_buffer);
+	if(vga_base)
+		dma_free_coherent(NULL, vga_size, vga_base, tx_phy_buffer);
 	printk(KERN_INFO "vga_dma_exit: Exit device module finished\"%s\".\n", DEVICE_NAME);
 }
 